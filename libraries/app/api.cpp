@@ -27,6 +27,7 @@
 #include <graphene/app/api.hpp>
 #include <graphene/app/api_access.hpp>
 #include <graphene/app/application.hpp>
+#include <graphene/api_helper_indexes/api_helper_indexes.hpp>
 #include <graphene/chain/database.hpp>
 #include <graphene/chain/get_config.hpp>
 #include <graphene/utilities/key_conversion.hpp>
@@ -145,7 +146,9 @@ namespace graphene { namespace app {
 
     network_broadcast_api::network_broadcast_api(application& a):_app(a)
     {
-       _applied_block_connection = _app.chain_database()->applied_block.connect([this](const signed_block& b){ on_applied_block(b); });
+       auto db = _app.chain_database();
+       _applied_block_connection = db->observe( db->applied_block, "network_broadcast_api",
+                                                [this](const signed_block& b){ on_applied_block(b); } );
     }
 
     void network_broadcast_api::on_applied_block( const signed_block& b )
@@ -239,6 +242,11 @@ namespace graphene { namespace app {
        return {};
     }
 
+    chain::pending_transactions_stats network_node_api::get_pending_transactions_stats() const
+    {
+       return _app.chain_database()->get_pending_transactions_stats();
+    }
+
     fc::variant_object network_node_api::get_advanced_node_parameters() const
     {
        FC_ASSERT( _app.p2p_node() != nullptr, "No P2P network!" );
@@ -551,6 +559,16 @@ namespace graphene { namespace app {
           ) { }
     asset_api::~asset_api() { }
 
+    static const graphene::api_helper_indexes::asset_holders_index& get_asset_holders_index(
+          application& app, const graphene::chain::database& db )
+    {
+       // api_helper_indexes plugin is required for accessing the secondary index
+       FC_ASSERT( app.get_options().has_api_helper_indexes_plugin,
+                  "api_helper_indexes plugin is not enabled on this server." );
+       return db.get_index_type< primary_index< account_balance_index > >()
+                .get_secondary_index< graphene::api_helper_indexes::asset_holders_index >();
+    }
+
     vector<account_asset_balance> asset_api::get_asset_holders( std::string asset, uint32_t start, uint32_t limit ) const
     {
        const auto configured_limit = _app.get_options().api_limit_get_asset_holders;
@@ -559,29 +577,28 @@ namespace graphene { namespace app {
                   ("configured_limit", configured_limit) );
 
        asset_id_type asset_id = database_api.get_asset_id_from_string( asset );
-       const auto& bal_idx = _db.get_index_type< account_balance_index >().indices().get< by_asset_balance >();
-       auto range = bal_idx.equal_range( boost::make_tuple( asset_id ) );
+       const auto& holders = get_asset_holders_index( _app, _db ).get_holders( asset_id );
 
        vector<account_asset_balance> result;
 
        uint32_t index = 0;
-       for( const account_balance_object& bal : boost::make_iterator_range( range.first, range.second ) )
+       for( const balance_holder& holder : holders )
        {
           if( result.size() >= limit )
              break;
 
-          if( bal.balance.value == 0 )
+          if( holder.balance.value == 0 )
              continue;
 
           if( index++ < start )
              continue;
 
-          const auto account = _db.find(bal.owner);
+          const auto account = _db.find(holder.owner);
 
           account_asset_balance aab;
           aab.name       = account->name;
           aab.account_id = account->id;
-          aab.amount     = bal.balance.value;
+          aab.amount     = holder.balance.value;
 
           result.push_back(aab);
        }
@@ -590,18 +607,17 @@ namespace graphene { namespace app {
     }
     // get number of asset holders.
     int asset_api::get_asset_holders_count( std::string asset ) const {
-       const auto& bal_idx = _db.get_index_type< account_balance_index >().indices().get< by_asset_balance >();
        asset_id_type asset_id = database_api.get_asset_id_from_string( asset );
-       auto range = bal_idx.equal_range( boost::make_tuple( asset_id ) );
+       const auto& holders = get_asset_holders_index( _app, _db ).get_holders( asset_id );
 
-       int count = boost::distance(range) - 1;
+       int count = holders.size() - 1;
 
        return count;
     }
     // function to get vector of system assets with holders count.
     vector<asset_holders> asset_api::get_all_asset_holders() const {
        vector<asset_holders> result;
-       vector<asset_id_type> total_assets;
+       const auto& holders_idx = get_asset_holders_index( _app, _db );
        for( const asset_object& asset_obj : _db.get_index_type<asset_index>().indices() )
        {
           const auto& dasset_obj = asset_obj.dynamic_asset_data_id(_db);
@@ -609,10 +625,7 @@ namespace graphene { namespace app {
           asset_id_type asset_id;
           asset_id = dasset_obj.id;
 
-          const auto& bal_idx = _db.get_index_type< account_balance_index >().indices().get< by_asset_balance >();
-          auto range = bal_idx.equal_range( boost::make_tuple( asset_id ) );
-
-          int count = boost::distance(range) - 1;
+          int count = holders_idx.get_holders( asset_id ).size() - 1;
 
           asset_holders ah;
           ah.asset_id       = asset_id;
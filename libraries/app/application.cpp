@@ -428,7 +428,7 @@ graphene::chain::genesis_state_type application_impl::initialize_genesis_state()
       {
          std::string genesis_str;
          fc::read_file_contents( _options->at("genesis-json").as<boost::filesystem::path>(), genesis_str );
-         auto genesis = fc::json::from_string( genesis_str ).as<graphene::chain::genesis_state_type>( 20 );
+         auto genesis = graphene::chain::genesis_state_type::from_json( genesis_str, 20 );
          bool modified_genesis = false;
          if( _options->count("genesis-timestamp") > 0 )
          {
@@ -462,11 +462,16 @@ graphene::chain::genesis_state_type application_impl::initialize_genesis_state()
       }
       else
       {
+         // The binary egenesis carries the chain ID computed at build time, no parsing or hashing needed
+         graphene::chain::genesis_state_type genesis;
+         if( graphene::egenesis::compute_egenesis_state( genesis ) )
+            return genesis;
+
          std::string egenesis_json;
          graphene::egenesis::compute_egenesis_json( egenesis_json );
          FC_ASSERT( egenesis_json != "" );
          FC_ASSERT( graphene::egenesis::get_egenesis_json_hash() == fc::sha256::hash( egenesis_json ) );
-         auto genesis = fc::json::from_string( egenesis_json ).as<graphene::chain::genesis_state_type>( 20 );
+         genesis = graphene::chain::genesis_state_type::from_json( egenesis_json, 20 );
          genesis.initial_chain_id = fc::sha256::hash( egenesis_json );
          return genesis;
       }
@@ -498,6 +503,24 @@ void application_impl::open_chain_database() const
       _chain_db->enable_standby_votes_tracking( _options->at("enable-standby-votes-tracking").as<bool>() );
    }
 
+   if( _options->count("enable-chain-profiler") > 0 )
+   {
+      _chain_db->enable_profiling( _options->at("enable-chain-profiler").as<bool>() );
+   }
+
+   {
+      chain::pending_transactions_limits limits;
+      if( _options->count("max-pending-transactions") > 0 )
+         limits.max_count = _options->at("max-pending-transactions").as<uint32_t>();
+      if( _options->count("max-pending-transactions-size") > 0 )
+         limits.max_size = _options->at("max-pending-transactions-size").as<uint64_t>();
+      if( _options->count("max-pending-transactions-per-account") > 0 )
+         limits.max_per_account = _options->at("max-pending-transactions-per-account").as<uint32_t>();
+      if( _options->count("max-block-assembly-time-ms") > 0 )
+         limits.max_assembly_time_ms = _options->at("max-block-assembly-time-ms").as<uint32_t>();
+      _chain_db->set_pending_transactions_limits( limits );
+   }
+
    if( _options->count("replay-blockchain") > 0 || _options->count("revalidate-blockchain") > 0 )
       _chain_db->wipe( _data_dir / "blockchain", false );
 
@@ -1151,6 +1174,17 @@ void application::set_program_options(boost::program_options::options_descriptio
          ("enable-standby-votes-tracking", bpo::value<bool>()->implicit_value(true),
           "Whether to enable tracking of votes of standby witnesses and committee members. "
           "Set it to true to provide accurate data to API clients, set to false for slightly better performance.")
+         ("enable-chain-profiler", bpo::value<bool>()->implicit_value(true),
+          "Whether to time operations, evaluator phases and block stages. The report is logged at the end of a "
+          "replay and can be fetched or reset through the debug API.")
+         ("max-pending-transactions", bpo::value<uint32_t>()->default_value(0),
+          "Maximum number of pending transactions kept by this node, 0 for unlimited")
+         ("max-pending-transactions-size", bpo::value<uint64_t>()->default_value(0),
+          "Maximum total size in bytes of pending transactions kept by this node, 0 for unlimited")
+         ("max-pending-transactions-per-account", bpo::value<uint32_t>()->default_value(0),
+          "Maximum number of pending transactions of one fee paying account, 0 for unlimited")
+         ("max-block-assembly-time-ms", bpo::value<uint32_t>()->default_value(0),
+          "Time after which a block being produced stops taking pending transactions, 0 for unlimited")
          ("api-limit-get-account-history-operations",
           bpo::value<uint64_t>()->default_value(default_opts.api_limit_get_account_history_operations),
           "For history_api::get_account_history_operations to set max limit value")
@@ -58,20 +58,22 @@ database_api_impl::database_api_impl( graphene::chain::database& db, const appli
 :_db(db), _app_options(app_options)
 {
    dlog("creating database api ${x}", ("x",int64_t(this)) );
-   _new_connection = _db.new_objects.connect([this](const vector<object_id_type>& ids,
-                                                    const flat_set<account_id_type>& impacted_accounts) {
-                                on_objects_new(ids, impacted_accounts);
-                                });
-   _change_connection = _db.changed_objects.connect([this](const vector<object_id_type>& ids,
-                                                           const flat_set<account_id_type>& impacted_accounts) {
-                                on_objects_changed(ids, impacted_accounts);
-                                });
-   _removed_connection = _db.removed_objects.connect([this](const vector<object_id_type>& ids,
-                                                            const vector<const object*>& objs,
-                                                            const flat_set<account_id_type>& impacted_accounts) {
-                                on_objects_removed(ids, objs, impacted_accounts);
-                                });
-   _applied_block_connection = _db.applied_block.connect([this](const signed_block&){ on_applied_block(); });
+   // database_api asks for the impacted accounts only while a client is subscribed to accounts
+   _new_connection = _db.observe_without_impacted_accounts( _db.new_objects, "database_api",
+         [this](const vector<object_id_type>& ids, const flat_set<account_id_type>& impacted_accounts) {
+            on_objects_new(ids, impacted_accounts);
+         });
+   _change_connection = _db.observe_without_impacted_accounts( _db.changed_objects, "database_api",
+         [this](const vector<object_id_type>& ids, const flat_set<account_id_type>& impacted_accounts) {
+            on_objects_changed(ids, impacted_accounts);
+         });
+   _removed_connection = _db.observe_without_impacted_accounts( _db.removed_objects, "database_api",
+         [this](const vector<object_id_type>& ids, const vector<const object*>& objs,
+                const flat_set<account_id_type>& impacted_accounts) {
+            on_objects_removed(ids, objs, impacted_accounts);
+         });
+   _applied_block_connection = _db.observe( _db.applied_block, "database_api",
+                                            [this](const signed_block&){ on_applied_block(); } );
 
    _pending_trx_connection = _db.on_pending_transaction.connect([this](const signed_transaction& trx ){
                                 if( _pending_trx_callback )
@@ -91,6 +93,8 @@ database_api_impl::database_api_impl( graphene::chain::database& db, const appli
 database_api_impl::~database_api_impl()
 {
    dlog("freeing database api ${x}", ("x",int64_t(this)) );
+   _subscribed_accounts.clear();
+   update_impacted_accounts_subscription();
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -195,6 +199,7 @@ void database_api_impl::cancel_all_subscriptions( bool reset_callback, bool rese
 
    _notify_remove_create = false;
    _subscribed_accounts.clear();
+   update_impacted_accounts_subscription();
    static fc::bloom_parameters param(10000, 1.0/100, 1024*8*8*2);
    _subscribe_filter = fc::bloom_filter(param);
 }
@@ -326,14 +331,17 @@ dynamic_global_property_object database_api_impl::get_dynamic_global_properties(
    return _db.get(dynamic_global_property_id_type());
 }
 
-witness_schedule_object database_api::get_witness_schedule()const
+witness_schedule database_api::get_witness_schedule()const
 {
    return my->get_witness_schedule();
 }
 
-witness_schedule_object database_api_impl::get_witness_schedule()const
+witness_schedule database_api_impl::get_witness_schedule()const
 {
-   return _db.get_witness_schedule_object();
+   witness_schedule result;
+   result.id = _db.get_witness_schedule_object().id;
+   result.current_shuffled_witnesses = _db.get_shuffled_witnesses();
+   return result;
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -501,6 +509,7 @@ std::map<std::string, full_account> database_api_impl::get_full_accounts( const
       {
          if(_subscribed_accounts.size() < 100) {
             _subscribed_accounts.insert( account->get_id() );
+            update_impacted_accounts_subscription();
             subscribe_to_item( account->id );
          }
       }
@@ -664,7 +673,7 @@ optional<account_object> database_api::get_account_by_name( string name )const
 
 optional<account_object> database_api_impl::get_account_by_name( string name )const
 {
-   const auto& idx = _db.get_index_type<account_index>().indices().get<by_name>();
+   const auto& idx = _db.get_index_type<account_index>().indices().get<by_name_hash>();
    auto itr = idx.find(name);
    if (itr != idx.end())
       return *itr;
@@ -777,6 +786,7 @@ vector<asset> database_api_impl::get_account_balances( const std::string& accoun
       const auto& balance_index = _db.get_index_type< primary_index< account_balance_index > >();
       const auto& balances = balance_index.get_secondary_index< balances_by_account_index >()
                                           .get_account_balances( acnt );
+      result.reserve( balances.size() );
       for( const auto& balance : balances )
          result.push_back( balance.second->get_balance() );
    }
@@ -871,26 +881,45 @@ vector<asset> database_api_impl::get_vested_balances( const vector<balance_id_ty
    } FC_CAPTURE_AND_RETHROW( (objs) )
 }
 
-vector<vesting_balance_object> database_api::get_vesting_balances( const std::string account_id_or_name )const
+vector<vesting_balance_object> database_api::get_vesting_balances( const std::string account_id_or_name,
+                                                                   const optional<std::string>& asset_symbol_or_id,
+                                                                   const optional<vesting_balance_type>& balance_type
+                                                                 )const
 {
-   return my->get_vesting_balances( account_id_or_name );
+   return my->get_vesting_balances( account_id_or_name, asset_symbol_or_id, balance_type );
 }
 
-vector<vesting_balance_object> database_api_impl::get_vesting_balances( const std::string account_id_or_name )const
+vector<vesting_balance_object> database_api_impl::get_vesting_balances( const std::string account_id_or_name,
+      const optional<std::string>& asset_symbol_or_id, const optional<vesting_balance_type>& balance_type )const
 {
    try
    {
       const account_id_type account_id = get_account_from_string(account_id_or_name)->id;
       vector<vesting_balance_object> result;
+      auto add_balance = [&result](const vesting_balance_object& balance) {
+         result.emplace_back(balance);
+      };
+      if( asset_symbol_or_id.valid() )
+      {
+         // look up the (account, asset[, type]) range directly
+         const asset_id_type asset_id = get_asset_from_string(*asset_symbol_or_id)->id;
+         const auto& vesting_idx = _db.get_index_type<vesting_balance_index>().indices().get<by_account_asset_type>();
+         auto vesting_range = balance_type.valid()
+                              ? vesting_idx.equal_range( boost::make_tuple( account_id, asset_id, *balance_type ) )
+                              : vesting_idx.equal_range( boost::make_tuple( account_id, asset_id ) );
+         std::for_each(vesting_range.first, vesting_range.second, add_balance);
+         return result;
+      }
       auto vesting_range = _db.get_index_type<vesting_balance_index>().indices().get<by_account>()
                               .equal_range(account_id);
       std::for_each(vesting_range.first, vesting_range.second,
-                    [&result](const vesting_balance_object& balance) {
-                       result.emplace_back(balance);
+                    [&add_balance,&balance_type](const vesting_balance_object& balance) {
+                       if( !balance_type.valid() || balance.balance_type == *balance_type )
+                          add_balance(balance);
                     });
       return result;
    }
-   FC_CAPTURE_AND_RETHROW( (account_id_or_name) );
+   FC_CAPTURE_AND_RETHROW( (account_id_or_name)(asset_symbol_or_id)(balance_type) );
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -2686,7 +2715,7 @@ const account_object* database_api_impl::get_account_from_string( const std::str
       account_ptr = _db.find(fc::variant(name_or_id, 1).as<account_id_type>(1));
    else
    {
-      const auto& idx = _db.get_index_type<account_index>().indices().get<by_name>();
+      const auto& idx = _db.get_index_type<account_index>().indices().get<by_name_hash>();
       auto itr = idx.find(name_or_id);
       if (itr != idx.end())
          account_ptr = &(*itr);
@@ -2779,6 +2808,18 @@ vector<limit_order_object> database_api_impl::get_limit_orders( const asset_id_t
    return result;
 }
 
+void database_api_impl::update_impacted_accounts_subscription()
+{
+   const bool needed = !_subscribed_accounts.empty();
+   if( needed == _impacted_accounts_subscribed )
+      return;
+   if( needed )
+      _db.subscribe_to_impacted_accounts();
+   else
+      _db.unsubscribe_from_impacted_accounts();
+   _impacted_accounts_subscribed = needed;
+}
+
 bool database_api_impl::is_impacted_account( const flat_set<account_id_type>& accounts)
 {
    if( _subscribed_accounts.empty() || accounts.empty() )
@@ -64,7 +64,7 @@ class database_api_impl : public std::enable_shared_from_this<database_api_impl>
       fc::variant_object get_config()const;
       chain_id_type get_chain_id()const;
       dynamic_global_property_object get_dynamic_global_properties()const;
-      witness_schedule_object get_witness_schedule()const;
+      witness_schedule get_witness_schedule()const;
 
       // Keys
       vector<flat_set<account_id_type>> get_key_references( vector<public_key_type> key )const;
@@ -91,7 +91,9 @@ class database_api_impl : public std::enable_shared_from_this<database_api_impl>
       vector<balance_object> get_balance_objects( const vector<address>& addrs )const;
       vector<ico_balance_object> get_ico_balance_objects( const vector<string>& addrs )const;
       vector<asset> get_vested_balances( const vector<balance_id_type>& objs )const;
-      vector<vesting_balance_object> get_vesting_balances( const std::string account_id_or_name )const;
+      vector<vesting_balance_object> get_vesting_balances( const std::string account_id_or_name,
+                                                           const optional<std::string>& asset_symbol_or_id,
+                                                           const optional<vesting_balance_type>& balance_type )const;
 
       // Assets
       uint64_t get_asset_count()const;
@@ -349,6 +351,9 @@ class database_api_impl : public std::enable_shared_from_this<database_api_impl>
                               const flat_set<account_id_type>& impacted_accounts);
       void on_applied_block();
 
+      /// Tell the database whether impacted accounts are needed, i.e. whether any account is subscribed to
+      void update_impacted_accounts_subscription();
+
       ////////////////////////////////////////////////
       // Member variables
       ////////////////////////////////////////////////
@@ -358,6 +363,7 @@ class database_api_impl : public std::enable_shared_from_this<database_api_impl>
 
       mutable fc::bloom_filter  _subscribe_filter;
       std::set<account_id_type> _subscribed_accounts;
+      bool _impacted_accounts_subscribed = false;
 
       std::function<void(const fc::variant&)> _subscribe_callback;
       std::function<void(const fc::variant&)> _pending_trx_callback;
@@ -28,6 +28,8 @@
 
 #include <graphene/protocol/types.hpp>
 
+#include <graphene/chain/pending_transactions.hpp>
+
 #include <graphene/market_history/market_history_plugin.hpp>
 #include <graphene/grouped_orders/grouped_orders_plugin.hpp>
 #include <graphene/custom_operations/custom_operations_plugin.hpp>
@@ -353,6 +355,11 @@ namespace graphene { namespace app {
           */
          std::vector<net::potential_peer_record> get_potential_peers() const;
 
+         /**
+          * @brief Get the size and admission counters of the pending transaction pool of this node
+          */
+         chain::pending_transactions_stats get_pending_transactions_stats() const;
+
       private:
          application& _app;
    };
@@ -568,6 +575,7 @@ FC_API(graphene::app::network_node_api,
        (get_potential_peers)
        (get_advanced_node_parameters)
        (set_advanced_node_parameters)
+       (get_pending_transactions_stats)
      )
 FC_API(graphene::app::asset_api,
        (get_asset_holders)
@@ -142,6 +142,13 @@ namespace graphene { namespace app {
       account_id_type            side2_account_id = GRAPHENE_NULL_ACCOUNT;
    };
 
+   /// The witness schedule of the current round, in production order
+   struct witness_schedule
+   {
+      witness_schedule_id_type   id;
+      vector< witness_id_type >  current_shuffled_witnesses;
+   };
+
    struct extended_asset_object : asset_object
    {
       extended_asset_object() {}
@@ -190,5 +197,6 @@ FC_REFLECT( graphene::app::market_volume, (time)(base)(quote)(base_volume)(quote
 FC_REFLECT( graphene::app::market_trade, (sequence)(date)(price)(amount)(value)(type)
             (side1_account_id)(side2_account_id) )
 
+FC_REFLECT( graphene::app::witness_schedule, (id)(current_shuffled_witnesses) )
 FC_REFLECT_DERIVED( graphene::app::extended_asset_object, (graphene::chain::asset_object),
                     (total_in_collateral)(total_backing_collateral) )
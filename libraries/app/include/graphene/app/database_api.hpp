@@ -225,9 +225,9 @@ class database_api
       dynamic_global_property_object get_dynamic_global_properties()const;
 
       /**
-       * @brief Retrieve the current @ref graphene::chain::witness_schedule_object
+       * @brief Retrieve the witnesses of the current round in production order
        */
-      witness_schedule_object get_witness_schedule()const;
+      witness_schedule get_witness_schedule()const;
 
       //////////
       // Keys //
@@ -369,11 +369,15 @@ class database_api
       vector<asset> get_vested_balances( const vector<balance_id_type>& objs )const;
 
       /**
-       * @brief Return all vesting balance objects owned by an account
+       * @brief Return the vesting balance objects owned by an account
        * @param account_name_or_id name or ID of an account
-       * @return all vesting balance objects owned by the account
+       * @param asset_symbol_or_id if set, only return the vesting balances in this asset
+       * @param balance_type if set, only return the vesting balances of this type
+       * @return the matching vesting balance objects owned by the account
        */
-      vector<vesting_balance_object> get_vesting_balances( const std::string account_name_or_id )const;
+      vector<vesting_balance_object> get_vesting_balances( const std::string account_name_or_id,
+            const optional<std::string>& asset_symbol_or_id = optional<std::string>(),
+            const optional<vesting_balance_type>& balance_type = optional<vesting_balance_type>() )const;
 
       /**
        * @brief Get the total number of accounts registered with the blockchain
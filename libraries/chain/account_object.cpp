@@ -250,6 +250,37 @@ void account_member_index::object_modified(const object& after)
 
 }
 
+namespace {
+   bool asset_less( const account_balance_map::value_type& entry, const asset_id_type& asset )
+   {
+      return entry.first < asset;
+   }
+}
+
+const account_balance_object* account_balance_map::find( const asset_id_type& asset )const
+{
+   auto itr = std::lower_bound( entries.begin(), entries.end(), asset, asset_less );
+   if( itr == entries.end() || itr->first != asset )
+      return nullptr;
+   return itr->second;
+}
+
+void account_balance_map::set( const asset_id_type& asset, const account_balance_object* balance )
+{
+   auto itr = std::lower_bound( entries.begin(), entries.end(), asset, asset_less );
+   if( itr != entries.end() && itr->first == asset )
+      itr->second = balance;
+   else
+      entries.emplace( itr, asset, balance );
+}
+
+void account_balance_map::erase( const asset_id_type& asset )
+{
+   auto itr = std::lower_bound( entries.begin(), entries.end(), asset, asset_less );
+   if( itr != entries.end() && itr->first == asset )
+      entries.erase( itr );
+}
+
 const uint8_t  balances_by_account_index::bits = 20;
 const uint64_t balances_by_account_index::mask = (1ULL << balances_by_account_index::bits) - 1;
 
@@ -262,7 +293,7 @@ void balances_by_account_index::object_inserted( const object& obj )
       balances.resize( balances.size() + 1 );
       balances.back().resize( 1ULL << bits );
    }
-   balances[abo.owner.instance.value >> bits][abo.owner.instance.value & mask][abo.asset_type] = &abo;
+   balances[abo.owner.instance.value >> bits][abo.owner.instance.value & mask].set( abo.asset_type, &abo );
 }
 
 void balances_by_account_index::object_removed( const object& obj )
@@ -283,9 +314,9 @@ void balances_by_account_index::object_modified( const object& after  )
    ids_being_modified.pop();
 }
 
-const map< asset_id_type, const account_balance_object* >& balances_by_account_index::get_account_balances( const account_id_type& acct )const
+const account_balance_map& balances_by_account_index::get_account_balances( const account_id_type& acct )const
 {
-   static const map< asset_id_type, const account_balance_object* > _empty;
+   static const account_balance_map _empty;
 
    if( balances.size() < (acct.instance.value >> bits) + 1 ) return _empty;
    return balances[acct.instance.value >> bits][acct.instance.value & mask];
@@ -294,10 +325,118 @@ const map< asset_id_type, const account_balance_object* >& balances_by_account_i
 const account_balance_object* balances_by_account_index::get_account_balance( const account_id_type& acct, const asset_id_type& asset )const
 {
    if( balances.size() < (acct.instance.value >> bits) + 1 ) return nullptr;
-   const auto& mine = balances[acct.instance.value >> bits][acct.instance.value & mask];
-   const auto itr = mine.find( asset );
-   if( mine.end() == itr ) return nullptr;
-   return itr->second;
+   return balances[acct.instance.value >> bits][acct.instance.value & mask].find( asset );
+}
+
+void balances_to_maintain_index::object_inserted( const object& obj )
+{
+   const auto& abo = static_cast< const account_balance_object& >( obj );
+   set_flagged( abo.id.instance(), abo.maintenance_flag );
+}
+
+void balances_to_maintain_index::object_removed( const object& obj )
+{
+   set_flagged( obj.id.instance(), false );
+}
+
+void balances_to_maintain_index::object_modified( const object& after  )
+{
+   object_inserted( after );
+}
+
+void balances_to_maintain_index::set_flagged( uint64_t instance, bool flagged )
+{
+   const size_t word = instance / 64;
+   const uint64_t bit = uint64_t(1) << ( instance % 64 );
+   if( word >= flagged_bits.size() )
+   {
+      if( !flagged )
+         return;
+      flagged_bits.resize( word + 1 );
+   }
+   const bool was_flagged = ( flagged_bits[word] & bit ) != 0;
+   if( was_flagged == flagged )
+      return;
+   if( flagged )
+   {
+      flagged_bits[word] |= bit;
+      ++flagged_count;
+   }
+   else
+   {
+      flagged_bits[word] &= ~bit;
+      --flagged_count;
+   }
+}
+
+vector< account_balance_id_type > balances_to_maintain_index::get_flagged_balances()const
+{
+   vector< account_balance_id_type > result;
+   result.reserve( flagged_count );
+   for( size_t word = 0; word < flagged_bits.size() && result.size() < flagged_count; ++word )
+   {
+      const uint64_t bits = flagged_bits[word];
+      if( bits == 0 )
+         continue;
+      for( uint64_t offset = 0; offset < 64; ++offset )
+      {
+         if( bits & ( uint64_t(1) << offset ) )
+            result.emplace_back( word * 64 + offset );
+      }
+   }
+   return result;
+}
+
+void balances_by_asset_index::object_inserted( const object& obj )
+{
+   const auto& abo = static_cast< const account_balance_object& >( obj );
+   auto itr = holders.find( abo.asset_type );
+   if( itr != holders.end() )
+      itr->second.insert( balance_holder{ abo.balance, abo.owner } );
+}
+
+void balances_by_asset_index::object_removed( const object& obj )
+{
+   const auto& abo = static_cast< const account_balance_object& >( obj );
+   auto itr = holders.find( abo.asset_type );
+   if( itr != holders.end() )
+      itr->second.erase( balance_holder{ abo.balance, abo.owner } );
+}
+
+void balances_by_asset_index::about_to_modify( const object& before )
+{
+   object_removed( before );
+}
+
+void balances_by_asset_index::object_modified( const object& after  )
+{
+   object_inserted( after );
+}
+
+const balance_holder_set& balances_by_asset_index::get_holders( const asset_id_type& asset, const index& balances )const
+{
+   auto itr = holders.find( asset );
+   if( itr != holders.end() )
+      return itr->second;
+
+   balance_holder_set& result = holders[asset];
+   balances.inspect_all_objects( [&result,&asset]( const object& obj ) {
+      const auto& abo = static_cast< const account_balance_object& >( obj );
+      if( abo.asset_type == asset )
+         result.insert( balance_holder{ abo.balance, abo.owner } );
+   });
+   return result;
+}
+
+void balances_by_asset_index::retain_assets( const flat_set< asset_id_type >& assets )const
+{
+   for( auto itr = holders.begin(); itr != holders.end(); )
+   {
+      if( assets.find( itr->first ) == assets.end() )
+         itr = holders.erase( itr );
+      else
+         ++itr;
+   }
 }
 
 } } // graphene::chain
@@ -45,11 +45,47 @@ share_type asset_bitasset_data_object::max_force_settlement_volume(share_type cu
    return static_cast<uint64_t>(volume);
 }
 
+namespace {
+
+/// Prices compare by ratio, but the stored representation matters for later calculations
+bool prices_identical( const price& a, const price& b )
+{
+   return a.base == b.base && a.quote == b.quote;
+}
+
+bool feeds_identical( const price_feed_with_icr& a, const price_feed_with_icr& b )
+{
+   return prices_identical( a.settlement_price, b.settlement_price )
+       && prices_identical( a.core_exchange_rate, b.core_exchange_rate )
+       && a.maintenance_collateral_ratio == b.maintenance_collateral_ratio
+       && a.maximum_short_squeeze_ratio == b.maximum_short_squeeze_ratio
+       && a.initial_collateral_ratio == b.initial_collateral_ratio;
+}
+
+void calculate_collateralization( const price_feed_with_icr& feed, price& maintenance, price& initial )
+{
+   maintenance = feed.maintenance_collateralization();
+   if( feed.initial_collateral_ratio > feed.maintenance_collateral_ratio ) // if ICR is above MCR
+      initial = feed.calculate_initial_collateralization();
+   else // if ICR is not above MCR
+      initial = maintenance;
+}
+
+} // anonymous namespace
+
 void graphene::chain::asset_bitasset_data_object::update_median_feeds( time_point_sec current_time,
                                                                        time_point_sec next_maintenance_time )
 {
-   current_feed_publication_time = current_time;
+   apply_median_feeds( calculate_median_feeds( current_time ) );
+}
+
+asset_bitasset_data_object::median_feed_result asset_bitasset_data_object::calculate_median_feeds(
+      time_point_sec current_time )const
+{
+   median_feed_result result;
+   result.publication_time = current_time;
    vector<std::reference_wrapper<const price_feed_with_icr>> current_feeds;
+   current_feeds.reserve( feeds.size() );
    // find feeds that were alive at current_time
    for( const pair<account_id_type, pair<time_point_sec,price_feed_with_icr>>& f : feeds )
    {
@@ -57,7 +93,7 @@ void graphene::chain::asset_bitasset_data_object::update_median_feeds( time_poin
           f.second.first != time_point_sec() )
       {
          current_feeds.emplace_back(f.second.second);
-         current_feed_publication_time = std::min(current_feed_publication_time, f.second.first);
+         result.publication_time = std::min(result.publication_time, f.second.first);
       }
    }
 
@@ -65,33 +101,30 @@ void graphene::chain::asset_bitasset_data_object::update_median_feeds( time_poin
    if( current_feeds.size() < options.minimum_feeds )
    {
       //... don't calculate a median, and set a null feed
-      feed_cer_updated = false; // new median cer is null, won't update asset_object anyway, set to false for better performance
-      current_feed_publication_time = current_time;
-      current_feed = price_feed_with_icr();
-      // update data derived from MCR, ICR and etc
-      refresh_cache();
-      return;
+      result.enough_feeds = false;
+      result.publication_time = current_time;
+      calculate_collateralization( result.feed, result.maintenance_collateralization,
+                                   result.initial_collateralization );
+      return result;
    }
+   result.enough_feeds = true;
    if( current_feeds.size() == 1 )
    {
-      if( current_feed.core_exchange_rate != current_feeds.front().get().core_exchange_rate )
-         feed_cer_updated = true;
-      current_feed = current_feeds.front();
-      // Note: perhaps can defer updating current_maintenance_collateralization for better performance
+      result.feed = current_feeds.front();
       const auto& exts = options.extensions.value;
       if( exts.maintenance_collateral_ratio.valid() )
-         current_feed.maintenance_collateral_ratio = *exts.maintenance_collateral_ratio;
+         result.feed.maintenance_collateral_ratio = *exts.maintenance_collateral_ratio;
       if( exts.maximum_short_squeeze_ratio.valid() )
-         current_feed.maximum_short_squeeze_ratio = *exts.maximum_short_squeeze_ratio;
+         result.feed.maximum_short_squeeze_ratio = *exts.maximum_short_squeeze_ratio;
       if( exts.initial_collateral_ratio.valid() )
-         current_feed.initial_collateral_ratio = *exts.initial_collateral_ratio;
-      // update data derived from MCR, ICR and etc
-      refresh_cache();
-      return;
+         result.feed.initial_collateral_ratio = *exts.initial_collateral_ratio;
+      calculate_collateralization( result.feed, result.maintenance_collateralization,
+                                   result.initial_collateralization );
+      return result;
    }
 
    // *** Begin Median Calculations ***
-   price_feed_with_icr median_feed;
+   price_feed_with_icr& median_feed = result.feed;
    const auto median_itr = current_feeds.begin() + current_feeds.size() / 2;
 #define CALCULATE_MEDIAN_VALUE(r, data, field_name) \
    std::nth_element( current_feeds.begin(), median_itr, current_feeds.end(), \
@@ -114,21 +147,38 @@ void graphene::chain::asset_bitasset_data_object::update_median_feeds( time_poin
 #undef CALCULATE_MEDIAN_VALUE
    // *** End Median Calculations ***
 
-   if( current_feed.core_exchange_rate != median_feed.core_exchange_rate )
-      feed_cer_updated = true;
-   current_feed = median_feed;
    // Note: perhaps can defer updating current_maintenance_collateralization for better performance
-   // update data derived from MCR, ICR and etc
-   refresh_cache();
+   calculate_collateralization( result.feed, result.maintenance_collateralization,
+                                result.initial_collateralization );
+   return result;
+}
+
+bool asset_bitasset_data_object::median_feeds_changed( const median_feed_result& result )const
+{
+   if( !result.enough_feeds && feed_cer_updated ) // would be reset
+      return true;
+   return result.publication_time != current_feed_publication_time
+       || !feeds_identical( result.feed, current_feed )
+       || !prices_identical( result.maintenance_collateralization, current_maintenance_collateralization )
+       || !prices_identical( result.initial_collateralization, current_initial_collateralization );
+}
+
+void asset_bitasset_data_object::apply_median_feeds( const median_feed_result& result )
+{
+   if( !result.enough_feeds )
+      feed_cer_updated = false; // new median cer is null, won't update asset_object anyway, set to false for better performance
+   else if( current_feed.core_exchange_rate != result.feed.core_exchange_rate )
+      feed_cer_updated = true;
+   current_feed_publication_time = result.publication_time;
+   current_feed = result.feed;
+   current_maintenance_collateralization = result.maintenance_collateralization;
+   current_initial_collateralization = result.initial_collateralization;
 }
 
 void asset_bitasset_data_object::refresh_cache()
 {
-   current_maintenance_collateralization = current_feed.maintenance_collateralization();
-   if( current_feed.initial_collateral_ratio > current_feed.maintenance_collateral_ratio ) // if ICR is above MCR
-      current_initial_collateralization = current_feed.calculate_initial_collateralization();
-   else // if ICR is not above MCR
-      current_initial_collateralization = current_maintenance_collateralization;
+   calculate_collateralization( current_feed, current_maintenance_collateralization,
+                                current_initial_collateralization );
 }
 
 price price_feed_with_icr::calculate_initial_collateralization()const
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2023 R-Squared Labs LLC, and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <graphene/chain/chain_profiler.hpp>
+
+#include <graphene/protocol/operations.hpp>
+
+#include <fc/log/logger.hpp>
+
+#include <algorithm>
+
+namespace graphene { namespace chain {
+
+namespace {
+
+   struct operation_name_visitor
+   {
+      typedef std::string result_type;
+
+      template<typename T>
+      std::string operator()( const T& )const
+      {
+         std::string name = fc::get_typename<T>::name();
+         auto pos = name.rfind( "::" );
+         return pos == std::string::npos ? name : name.substr( pos + 2 );
+      }
+   };
+
+   std::string operation_name( int64_t which )
+   {
+      protocol::operation op;
+      op.set_which( which );
+      return op.visit( operation_name_visitor() );
+   }
+
+   uint64_t to_us( uint64_t ns ) { return ns / 1000; }
+
+   chain_profile_counter make_counter( const std::string& name, const chain_profiler::counter& c )
+   {
+      chain_profile_counter result;
+      result.name     = name;
+      result.count    = c.count;
+      result.total_us = to_us( c.total_ns );
+      result.max_us   = to_us( c.max_ns );
+      return result;
+   }
+
+   bool by_total_desc( const chain_profile_counter& a, const chain_profile_counter& b )
+   {
+      return a.total_us > b.total_us;
+   }
+
+   const char* const stage_names[ chain_profiler::STAGE_COUNT ] = {
+      "header",
+      "transactions",
+      "authority",
+      "witness_updates",
+      "tickets",
+      "maintenance",
+      "expirations",
+      "schedule",
+      "applied_block_notify",
+      "changed_objects_notify"
+   };
+
+}
+
+chain_profiler::chain_profiler()
+{
+   reset();
+}
+
+void chain_profiler::reset()
+{
+   _blocks = 0;
+   _operations.assign( protocol::operation::count(), std::array< counter, PHASE_COUNT >() );
+   _stages.fill( counter() );
+   _observers.clear();
+   _since = std::chrono::steady_clock::now();
+}
+
+chain_profile_report chain_profiler::get_report()const
+{
+   chain_profile_report report;
+   report.blocks = _blocks;
+   report.elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                          std::chrono::steady_clock::now() - _since ).count();
+
+   report.stages.reserve( STAGE_COUNT );
+   for( size_t i = 0; i < STAGE_COUNT; ++i )
+   {
+      if( _stages[i].count > 0 )
+         report.stages.push_back( make_counter( stage_names[i], _stages[i] ) );
+   }
+
+   for( size_t which = 0; which < _operations.size(); ++which )
+   {
+      const auto& phases = _operations[which];
+      if( phases[phase_total].count == 0 )
+         continue;
+      chain_profile_operation op;
+      op.operation   = operation_name( which );
+      op.count       = phases[phase_total].count;
+      op.total_us    = to_us( phases[phase_total].total_ns );
+      op.max_us      = to_us( phases[phase_total].max_ns );
+      op.fee_us      = to_us( phases[phase_fee].total_ns );
+      op.evaluate_us = to_us( phases[phase_evaluate].total_ns );
+      op.apply_us    = to_us( phases[phase_apply].total_ns );
+      report.operations.push_back( std::move(op) );
+   }
+
+   report.observers.reserve( _observers.size() );
+   for( const auto& item : _observers )
+      report.observers.push_back( make_counter( item.first, item.second ) );
+
+   std::sort( report.stages.begin(), report.stages.end(), by_total_desc );
+   std::sort( report.observers.begin(), report.observers.end(), by_total_desc );
+   std::sort( report.operations.begin(), report.operations.end(),
+              []( const chain_profile_operation& a, const chain_profile_operation& b ) {
+                 return a.total_us > b.total_us;
+              } );
+   return report;
+}
+
+void chain_profiler::log_report()const
+{
+   const chain_profile_report report = get_report();
+   ilog( "Chain profile: ${b} blocks in ${t} sec", ("b", report.blocks)("t", double(report.elapsed_us) / 1000000.0) );
+   for( const auto& s : report.stages )
+      ilog( "   stage ${s}: ${n} calls, total ${t} us, max ${m} us",
+            ("s", s.name)("n", s.count)("t", s.total_us)("m", s.max_us) );
+   for( const auto& o : report.operations )
+      ilog( "   op ${o}: ${n} calls, total ${t} us (fee ${f}, evaluate ${e}, apply ${a}), max ${m} us",
+            ("o", o.operation)("n", o.count)("t", o.total_us)("f", o.fee_us)("e", o.evaluate_us)
+            ("a", o.apply_us)("m", o.max_us) );
+   for( const auto& s : report.observers )
+      ilog( "   observer ${s}: ${n} calls, total ${t} us, max ${m} us",
+            ("s", s.name)("n", s.count)("t", s.total_us)("m", s.max_us) );
+}
+
+} } // graphene::chain
@@ -111,17 +111,25 @@ namespace detail {
    };
 } //detail
 
-asset database::get_market_fee_vesting_balance(const account_id_type &account_id, const asset_id_type &asset_id)
+const vesting_balance_object* database::find_market_fee_vesting_balance( const account_id_type& account_id,
+                                                                         const asset_id_type& asset_id )const
 {
-   auto& vesting_balances = get_index_type<vesting_balance_index>().indices().get<by_vesting_type>();
-   const auto& key = detail::vbo_mfs_key{account_id, asset_id};
+   const auto& vesting_balances = get_index_type<vesting_balance_index>().indices().get<by_vesting_type>();
+   const detail::vbo_mfs_key key{account_id, asset_id};
    auto vbo_it = vesting_balances.find(key, key, key);
-
    if( vbo_it == vesting_balances.end() )
+      return nullptr;
+   return &(*vbo_it);
+}
+
+asset database::get_market_fee_vesting_balance(const account_id_type &account_id, const asset_id_type &asset_id)
+{
+   const vesting_balance_object* vbo = find_market_fee_vesting_balance( account_id, asset_id );
+   if( vbo == nullptr )
    {
       return asset(0, asset_id);
    }
-   return vbo_it->balance;
+   return vbo->balance;
 }
 
 void database::deposit_market_fee_vesting_balance(const account_id_type &account_id, const asset &delta)
@@ -131,13 +139,9 @@ void database::deposit_market_fee_vesting_balance(const account_id_type &account
    if( delta.amount == 0 )
       return;
 
-   auto& vesting_balances = get_index_type<vesting_balance_index>().indices().get<by_vesting_type>();
-   const auto& key = detail::vbo_mfs_key{account_id, delta.asset_id};
-   auto vbo_it = vesting_balances.find(key, key, key);
-
-   auto block_time = head_block_time();
+   const vesting_balance_object* existing = find_market_fee_vesting_balance( account_id, delta.asset_id );
 
-   if( vbo_it == vesting_balances.end() )
+   if( existing == nullptr )
    {
       create<vesting_balance_object>([&account_id, &delta](vesting_balance_object &vbo) {
          vbo.owner = account_id;
@@ -146,7 +150,8 @@ void database::deposit_market_fee_vesting_balance(const account_id_type &account
          vbo.policy = instant_vesting_policy{};
       });
    } else {
-      modify( *vbo_it, [&block_time, &delta]( vesting_balance_object& vbo )
+      const auto block_time = head_block_time();
+      modify( *existing, [&block_time, &delta]( vesting_balance_object& vbo )
       {
          vbo.deposit_vested(block_time, delta);
       });
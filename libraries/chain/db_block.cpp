@@ -36,15 +36,80 @@
 #include <graphene/chain/witness_object.hpp>
 #include <graphene/chain/exceptions.hpp>
 #include <graphene/chain/evaluator.hpp>
+#include <graphene/chain/htlc_object.hpp>
 #include <graphene/chain/witness_schedule_object.hpp>
 
 #include <graphene/protocol/fee_schedule.hpp>
 
 #include <fc/io/raw.hpp>
 #include <fc/thread/parallel.hpp>
+#include <fc/uint128.hpp>
+
+#include <algorithm>
 
 namespace graphene { namespace chain {
 
+namespace detail {
+
+   struct pending_fee_payer_visitor
+   {
+      typedef account_id_type result_type;
+
+      template<typename Op>
+      account_id_type operator()( const Op& op )const { return op.fee_payer(); }
+   };
+
+   struct pending_fee_visitor
+   {
+      typedef asset result_type;
+
+      template<typename Op>
+      asset operator()( const Op& op )const { return op.fee; }
+   };
+
+   /// The account paying the fee of the first operation, which the pending transaction pool accounts to
+   account_id_type pending_fee_payer( const transaction& trx )
+   {
+      return trx.operations.front().visit( pending_fee_payer_visitor() );
+   }
+
+   /// Fees of a transaction in core asset, fees paid in other assets are converted at their core exchange rate
+   share_type pending_core_fee( const database& db, const transaction& trx )
+   {
+      try {
+         share_type result = 0;
+         for( const operation& op : trx.operations )
+         {
+            const asset fee = op.visit( pending_fee_visitor() );
+            if( fee.asset_id == asset_id_type() )
+               result += fee.amount;
+            else
+               result += ( fee * fee.asset_id( db ).options.core_exchange_rate ).amount;
+         }
+         return result;
+      } catch( const fc::exception& e ) {
+         // overflow or unknown fee asset, the transaction will most likely fail to apply anyway
+         wlog( "Unable to convert the fees of pending transaction ${id} to core, ordering it last: ${e}",
+               ("id",trx.id())("e",e.to_string()) );
+         return 0;
+      }
+   }
+
+   struct pending_priority
+   {
+      fc::uint128_t                 fee;
+      uint64_t                      size;
+      const processed_transaction*  trx;
+   };
+
+   /// Higher fee per byte first
+   bool pays_more_per_byte( const pending_priority& a, const pending_priority& b )
+   {
+      return a.fee * b.size > b.fee * a.size;
+   }
+
+} // detail
+
 bool database::is_known_block( const block_id_type& id )const
 {
    return _fork_db.is_known_block(id) || _block_id_to_block.contains(id);
@@ -82,12 +147,30 @@ optional<signed_block> database::fetch_block_by_number( uint32_t num )const
       return _block_id_to_block.fetch_by_number(num);
 }
 
-const signed_transaction& database::get_recent_transaction(const transaction_id_type& trx_id) const
+signed_transaction database::get_recent_transaction(const transaction_id_type& trx_id) const
 {
    auto& index = get_index_type<transaction_index>().indices().get<by_trx_id>();
    auto itr = index.find(trx_id);
    FC_ASSERT(itr != index.end());
-   return itr->trx;
+
+   if( itr->block_num > head_block_num() )
+   {
+      for( const processed_transaction& trx : _pending_tx )
+         if( trx.id() == trx_id )
+            return trx;
+   }
+   else
+   {
+      const optional<signed_block> block = fetch_block_by_number( itr->block_num );
+      if( block.valid() )
+      {
+         for( const processed_transaction& trx : block->transactions )
+            if( trx.id() == trx_id )
+               return trx;
+      }
+   }
+   FC_THROW( "Transaction ${id} is known but could not be found in block ${n}",
+             ("id",trx_id)("n",itr->block_num) );
 }
 
 std::vector<block_id_type> database::get_block_ids_on_fork(block_id_type head_of_fork) const
@@ -169,7 +252,9 @@ bool database::_push_block(const signed_block& new_block)
                try {
                   undo_database::session session = _undo_db.start_undo_session();
                   apply_block( (*ritr)->data, skip );
-                  update_witnesses( **ritr );
+                  // like for a single block below, the schedule is only needed to verify recent blocks
+                  if( (*ritr)->data.timestamp.sec_since_epoch() > now - 86400 )
+                     update_witnesses( **ritr );
                   _block_id_to_block.store( (*ritr)->id, (*ritr)->data );
                   session.commit();
                }
@@ -246,13 +331,13 @@ void database::update_witnesses( fork_item& fork_entry )const
    fork_entry.next_block_aslot = dpo.current_aslot + 1;
    fork_entry.next_block_time = get_slot_time( 1 );
 
-   const witness_schedule_object& wso = get_witness_schedule_object();
+   const vector< witness_id_type > shuffled_witnesses = get_shuffled_witnesses();
    fork_entry.scheduled_witnesses = std::make_shared< vector< pair< witness_id_type, public_key_type > > >();
-   fork_entry.scheduled_witnesses->reserve( wso.current_shuffled_witnesses.size() );
-   for( size_t i = 0; i < wso.current_shuffled_witnesses.size(); ++i )
+   fork_entry.scheduled_witnesses->reserve( shuffled_witnesses.size() );
+   for( const witness_id_type& witness_id : shuffled_witnesses )
    {
-       const auto& witness = wso.current_shuffled_witnesses[i](*this);
-       fork_entry.scheduled_witnesses->emplace_back( wso.current_shuffled_witnesses[i], witness.signing_key );
+       const auto& witness = witness_id(*this);
+       fork_entry.scheduled_witnesses->emplace_back( witness_id, witness.signing_key );
    }
 }
 
@@ -268,16 +353,42 @@ void database::update_witnesses( fork_item& fork_entry )const
 processed_transaction database::push_transaction( const precomputable_transaction& trx, uint32_t skip )
 { try {
    // see https://github.com/bitshares/bitshares-core/issues/1573
-   FC_ASSERT( fc::raw::pack_size( trx ) < (1024 * 1024), "Transaction exceeds maximum transaction size." );
+   const uint64_t trx_size = trx.get_packed_size();
+   FC_ASSERT( trx_size < (1024 * 1024), "Transaction exceeds maximum transaction size." );
    processed_transaction result;
    detail::with_skip_flags( *this, skip, [&]()
    {
-      result = _push_transaction( trx );
+      precheck_transaction( trx );
+      _check_pending_transactions_limits( trx, trx_size );
+      result = _push_transaction( trx, true );
    } );
    return result;
 } FC_CAPTURE_AND_RETHROW( (trx) ) }
 
-processed_transaction database::_push_transaction( const precomputable_transaction& trx )
+void database::_check_pending_transactions_limits( const precomputable_transaction& trx, uint64_t trx_size )
+{
+   const pending_transactions_limits& limits = _pending_tx_limits;
+   if( ( limits.max_count > 0 && _pending_tx_stats.count >= limits.max_count )
+       || ( limits.max_size > 0 && _pending_tx_stats.size + trx_size > limits.max_size ) )
+   {
+      ++_pending_tx_stats.rejected_pool_full;
+      FC_THROW( "The pending transaction pool is full (${n} transactions, ${s} bytes), please retry later",
+                ("n",_pending_tx_stats.count)("s",_pending_tx_stats.size) );
+   }
+   if( limits.max_per_account > 0 && !trx.operations.empty() )
+   {
+      const account_id_type payer = detail::pending_fee_payer( trx );
+      auto itr = _pending_tx_per_account.find( payer );
+      if( itr != _pending_tx_per_account.end() && itr->second >= limits.max_per_account )
+      {
+         ++_pending_tx_stats.rejected_account_limit;
+         FC_THROW( "Account ${a} already has ${n} pending transactions, please retry later",
+                   ("a",payer)("n",itr->second) );
+      }
+   }
+}
+
+processed_transaction database::_push_transaction( const precomputable_transaction& trx, bool prechecked )
 {
    // If this is the first transaction pushed after applying a block, start a new undo session.
    // This allows us to quickly rewind to the clean state of the head block, in case a new block arrives.
@@ -290,13 +401,19 @@ processed_transaction database::_push_transaction( const precomputable_transacti
    // apply the changes.
 
    auto temp_session = _undo_db.start_undo_session();
-   auto processed_trx = _apply_transaction( trx );
+   auto processed_trx = _apply_transaction( trx, prechecked );
    _pending_tx.push_back(processed_trx);
+   ++_pending_tx_stats.count;
+   _pending_tx_stats.size += trx.get_packed_size();
+   if( !trx.operations.empty() )
+      ++_pending_tx_per_account[ detail::pending_fee_payer( trx ) ];
 
    // notify_changed_objects();
    // The transaction applied successfully. Merge its changes into the pending block session.
    temp_session.merge();
 
+   _remember_signature_keys( trx );
+
    // notify anyone listening to pending transactions
    notify_on_pending_transaction( trx );
    return processed_trx;
@@ -421,9 +538,37 @@ signed_block database::_generate_block(
 
    _pending_tx_session = _undo_db.start_undo_session();
 
-   uint64_t postponed_tx_count = 0;
+   // If the pending transactions do not all fit into the block, include the ones paying the highest fee per byte.
+   // Otherwise keep the arrival order, so that transactions depending on earlier ones apply in the same block.
+   vector< detail::pending_priority > candidates;
+   candidates.reserve( _pending_tx.size() );
    for( const processed_transaction& tx : _pending_tx )
+      candidates.push_back( { 0, 0, &tx } );
+   if( total_block_size + _pending_tx_stats.size > maximum_block_size )
+   {
+      for( detail::pending_priority& candidate : candidates )
+      {
+         candidate.fee = detail::pending_core_fee( *this, *candidate.trx ).value;
+         candidate.size = fc::raw::pack_size( *candidate.trx );
+      }
+      std::stable_sort( candidates.begin(), candidates.end(), detail::pays_more_per_byte );
+   }
+
+   const fc::time_point assembly_start = fc::time_point::now();
+   const fc::microseconds max_assembly_time = fc::milliseconds( _pending_tx_limits.max_assembly_time_ms );
+   uint64_t postponed_tx_count = 0;
+   for( const detail::pending_priority& candidate : candidates )
    {
+      const processed_transaction& tx = *candidate.trx;
+
+      // postpone transaction if block assembly is taking too long
+      if( _pending_tx_limits.max_assembly_time_ms > 0
+          && fc::time_point::now() - assembly_start > max_assembly_time )
+      {
+         postponed_tx_count++;
+         continue;
+      }
+
       size_t new_total_size = total_block_size + fc::raw::pack_size( tx );
 
       // postpone transaction if it would make block too big
@@ -463,8 +608,11 @@ signed_block database::_generate_block(
    }
    if( postponed_tx_count > 0 )
    {
-      wlog( "Postponed ${n} transactions due to block size limit", ("n", postponed_tx_count) );
+      wlog( "Postponed ${n} transactions due to block size or assembly time limit", ("n", postponed_tx_count) );
    }
+   _pending_tx_stats.last_block_included = pending_block.transactions.size();
+   _pending_tx_stats.last_block_postponed = postponed_tx_count;
+   _pending_tx_stats.last_block_assembly_us = ( fc::time_point::now() - assembly_start ).count();
 
    _pending_tx_session.reset();
 
@@ -511,12 +659,19 @@ void database::clear_pending()
 { try {
    assert( (_pending_tx.size() == 0) || _pending_tx_session.valid() );
    _pending_tx.clear();
+   _pending_tx_stats.count = 0;
+   _pending_tx_stats.size = 0;
+   _pending_tx_per_account.clear();
    _pending_tx_session.reset();
 } FC_CAPTURE_AND_RETHROW() }
 
 uint32_t database::push_applied_operation( const operation& op )
 {
-   _applied_ops.emplace_back(op);
+   return push_applied_operation( operation( op ) );
+}
+uint32_t database::push_applied_operation( operation&& op )
+{
+   _applied_ops.emplace_back( std::move(op) );
    operation_history_object& oh = *(_applied_ops.back());
    oh.block_num    = _current_block_num;
    oh.trx_in_block = _current_trx_in_block;
@@ -525,10 +680,14 @@ uint32_t database::push_applied_operation( const operation& op )
    return _applied_ops.size() - 1;
 }
 void database::set_applied_operation_result( uint32_t op_id, const operation_result& result )
+{
+   set_applied_operation_result( op_id, operation_result( result ) );
+}
+void database::set_applied_operation_result( uint32_t op_id, operation_result&& result )
 {
    assert( op_id < _applied_ops.size() );
    if( _applied_ops[op_id] )
-      _applied_ops[op_id]->result = result;
+      _applied_ops[op_id]->result = std::move(result);
    else
    {
       elog( "Could not set operation result (head_block_num=${b})", ("b", head_block_num()) );
@@ -568,19 +727,28 @@ void database::_apply_block( const signed_block& next_block )
    uint32_t skip = get_node_properties().skip_flags;
    _applied_ops.clear();
 
-   if( !(skip & skip_block_size_check) )
+   chain_profiler* profiler = _profiler.get();
+   if( profiler )
+      profiler->count_block();
+
+   const witness_object* signing_witness = nullptr;
    {
-      FC_ASSERT( fc::raw::pack_size(next_block) <= get_global_properties().parameters.maximum_block_size );
-   }
+      chain_profiler::scoped_timer timer( profiler, chain_profiler::stage_header );
 
-   FC_ASSERT( (skip & skip_merkle_check) || next_block.transaction_merkle_root == next_block.calculate_merkle_root(),
-              "",
-              ("next_block.transaction_merkle_root",next_block.transaction_merkle_root)
-              ("calc",next_block.calculate_merkle_root())
-              ("next_block",next_block)
-              ("id",next_block.id()) );
+      if( !(skip & skip_block_size_check) )
+      {
+         FC_ASSERT( fc::raw::pack_size(next_block) <= get_global_properties().parameters.maximum_block_size );
+      }
+
+      FC_ASSERT( (skip & skip_merkle_check) || next_block.transaction_merkle_root == next_block.calculate_merkle_root(),
+                 "",
+                 ("next_block.transaction_merkle_root",next_block.transaction_merkle_root)
+                 ("calc",next_block.calculate_merkle_root())
+                 ("next_block",next_block)
+                 ("id",next_block.id()) );
 
-   const witness_object& signing_witness = validate_block_header(skip, next_block);
+      signing_witness = &validate_block_header(skip, next_block);
+   }
    const auto& global_props = get_global_properties();
    const auto& dynamic_global_props = get_dynamic_global_properties();
    bool maint_needed = (dynamic_global_props.next_maintenance_time <= next_block.timestamp);
@@ -594,55 +762,78 @@ void database::_apply_block( const signed_block& next_block )
    _current_block_num    = next_block_num;
    _current_trx_in_block = 0;
 
-   for( const auto& trx : next_block.transactions )
    {
-      /* We do not need to push the undo state for each transaction
-       * because they either all apply and are valid or the
-       * entire block fails to apply.  We only need an "undo" state
-       * for transactions when validating broadcast transactions or
-       * when building a block.
-       */
-      apply_transaction( trx, skip );
-      ++_current_trx_in_block;
+      chain_profiler::scoped_timer timer( profiler, chain_profiler::stage_transactions );
+      for( const auto& trx : next_block.transactions )
+      {
+         /* We do not need to push the undo state for each transaction
+          * because they either all apply and are valid or the
+          * entire block fails to apply.  We only need an "undo" state
+          * for transactions when validating broadcast transactions or
+          * when building a block.
+          */
+         apply_transaction( trx, skip );
+         ++_current_trx_in_block;
+      }
    }
 
    _current_op_in_trx    = 0;
    _current_virtual_op   = 0;
 
-   const uint32_t missed = update_witness_missed_blocks( next_block );
-   update_global_dynamic_data( next_block, missed );
-   update_signing_witness(signing_witness, next_block);
-   update_last_irreversible_block();
+   {
+      chain_profiler::scoped_timer timer( profiler, chain_profiler::stage_witness_updates );
+      const uint32_t missed = update_witness_missed_blocks( next_block );
+      update_global_dynamic_data( next_block, missed );
+      update_signing_witness(*signing_witness, next_block);
+      update_last_irreversible_block();
+   }
 
-   process_tickets();
+   {
+      chain_profiler::scoped_timer timer( profiler, chain_profiler::stage_tickets );
+      process_tickets();
+   }
 
    // Are we at the maintenance interval?
    if( maint_needed )
+   {
+      chain_profiler::scoped_timer timer( profiler, chain_profiler::stage_maintenance );
       perform_chain_maintenance(next_block, global_props);
+   }
+
+   {
+      chain_profiler::scoped_timer timer( profiler, chain_profiler::stage_expirations );
+      create_block_summary(next_block);
+      clear_expired_transactions();
+      _forget_signature_keys( next_block );
+      clear_expired_proposals();
+      clear_expired_orders();
+      clear_expired_htlcs();
+      update_expired_feeds();       // this will update expired feeds and some core exchange rates
+      update_core_exchange_rates(); // this will update remaining core exchange rates
+      update_withdraw_permissions();
+   }
 
-   create_block_summary(next_block);
-   clear_expired_transactions();
-   clear_expired_proposals();
-   clear_expired_orders();
-   clear_expired_htlcs();
-   update_expired_feeds();       // this will update expired feeds and some core exchange rates
-   update_core_exchange_rates(); // this will update remaining core exchange rates
-   update_withdraw_permissions();
-
-   // n.b., update_maintenance_flag() happens this late
-   // because get_slot_time() / get_slot_at_time() is needed above
-   // TODO:  figure out if we could collapse this function into
-   // update_global_dynamic_data() as perhaps these methods only need
-   // to be called for header validation?
-   update_maintenance_flag( maint_needed );
-   update_witness_schedule();
-   if( !_node_property_object.debug_updates.empty() )
-      apply_debug_updates();
-
-   // notify observers that the block has been applied
-   notify_applied_block( next_block ); //emit
+   {
+      chain_profiler::scoped_timer timer( profiler, chain_profiler::stage_schedule );
+      // n.b., update_maintenance_flag() happens this late
+      // because get_slot_time() / get_slot_at_time() is needed above
+      // TODO:  figure out if we could collapse this function into
+      // update_global_dynamic_data() as perhaps these methods only need
+      // to be called for header validation?
+      update_maintenance_flag( maint_needed );
+      update_witness_schedule();
+      if( !_node_property_object.debug_updates.empty() )
+         apply_debug_updates();
+   }
+
+   {
+      chain_profiler::scoped_timer timer( profiler, chain_profiler::stage_applied_block_notify );
+      // notify observers that the block has been applied
+      notify_applied_block( next_block ); //emit
+   }
    _applied_ops.clear();
 
+   chain_profiler::scoped_timer timer( profiler, chain_profiler::stage_changed_objects_notify );
    notify_changed_objects();
 } FC_CAPTURE_AND_RETHROW( (next_block.block_num()) )  }
 
@@ -658,42 +849,25 @@ processed_transaction database::apply_transaction(const signed_transaction& trx,
    return result;
 }
 
-processed_transaction database::_apply_transaction(const signed_transaction& trx)
-{ try {
-   uint32_t skip = get_node_properties().skip_flags;
-
-   trx.validate();
-
-   auto& trx_idx = get_mutable_index_type<transaction_index>();
-   const chain_id_type& chain_id = get_chain_id();
+void database::_check_transaction_dupe( const signed_transaction& trx, uint32_t skip )const
+{
    if( !(skip & skip_transaction_dupe_check) )
    {
-      GRAPHENE_ASSERT( trx_idx.indices().get<by_trx_id>().find(trx.id()) == trx_idx.indices().get<by_trx_id>().end(),
+      const auto& trx_idx = get_index_type<transaction_index>().indices().get<by_trx_id>();
+      GRAPHENE_ASSERT( trx_idx.find(trx.id()) == trx_idx.end(),
                        duplicate_transaction,
                        "Transaction '${txid}' is already in the database",
                        ("txid",trx.id()) );
    }
-   transaction_evaluation_state eval_state(this);
-   const chain_parameters& chain_parameters = get_global_properties().parameters;
-   eval_state._trx = &trx;
-
-   if( !(skip & skip_transaction_signatures) )
-   {
-      bool allow_non_immediate_owner = true;
-      auto get_active = [this]( account_id_type id ) { return &id(*this).active; };
-      auto get_owner  = [this]( account_id_type id ) { return &id(*this).owner;  };
-      auto get_custom = [this]( account_id_type id, const operation& op, rejected_predicate_map* rejects ) {
-         return get_viable_custom_authorities(id, op, rejects);
-      };
-
-      trx.verify_authority(chain_id, get_active, get_owner, get_custom, allow_non_immediate_owner,
-                           false, get_global_properties().parameters.max_authority_depth);
-   }
+}
 
+void database::_check_transaction_tapos_and_expiration( const signed_transaction& trx, uint32_t skip )const
+{
    //Skip all manner of expiration and TaPoS checking if we're on block 1; It's impossible that the transaction is
    //expired, and TaPoS makes no sense as no blocks exist.
    if( BOOST_LIKELY(head_block_num() > 0) )
    {
+      const chain_parameters& chain_parameters = get_global_properties().parameters;
       if( !(skip & skip_tapos_check) )
       {
          const auto& tapos_block_summary = block_summary_id_type( trx.ref_block_num )(*this);
@@ -711,13 +885,52 @@ processed_transaction database::_apply_transaction(const signed_transaction& trx
          FC_ASSERT( trx.get_packed_size() <= chain_parameters.maximum_transaction_size,
                "Transaction exceeds maximum transaction size." );
    }
+}
+
+void database::precheck_transaction( const signed_transaction& trx )const
+{
+   const uint32_t skip = get_node_properties().skip_flags;
+   _check_transaction_dupe( trx, skip );
+   _check_transaction_tapos_and_expiration( trx, skip );
+}
+
+processed_transaction database::_apply_transaction(const signed_transaction& trx, bool prechecked)
+{ try {
+   uint32_t skip = get_node_properties().skip_flags;
+
+   trx.validate();
+
+   const chain_id_type& chain_id = get_chain_id();
+   if( !prechecked )
+      _check_transaction_dupe( trx, skip );
+   transaction_evaluation_state eval_state(this);
+   eval_state._trx = &trx;
+
+   if( !(skip & skip_transaction_signatures) )
+   {
+      bool allow_non_immediate_owner = true;
+      auto get_active = [this]( account_id_type id ) { return &id(*this).active; };
+      auto get_owner  = [this]( account_id_type id ) { return &id(*this).owner;  };
+      auto get_custom = [this]( account_id_type id, const operation& op, rejected_predicate_map* rejects ) {
+         return get_viable_custom_authorities(id, op, rejects);
+      };
+
+      chain_profiler::scoped_timer timer( _profiler.get(), chain_profiler::stage_authority );
+      trx.verify_authority(chain_id, get_active, get_owner, get_custom, allow_non_immediate_owner,
+                           false, get_global_properties().parameters.max_authority_depth);
+   }
+
+   if( !prechecked )
+      _check_transaction_tapos_and_expiration( trx, skip );
 
    //Insert transaction into unique transactions database.
    if( !(skip & skip_transaction_dupe_check) )
    {
-      create<transaction_history_object>([&trx](transaction_history_object& transaction) {
+      const uint32_t block_num = head_block_num() + 1;
+      create<transaction_history_object>([&trx,block_num](transaction_history_object& transaction) {
          transaction.trx_id = trx.id();
-         transaction.trx = trx;
+         transaction.expiration = trx.expiration;
+         transaction.block_num = block_num;
       });
    }
 
@@ -745,6 +958,7 @@ operation_result database::apply_operation(transaction_evaluation_state& eval_st
    FC_ASSERT( u_which < _operation_evaluators.size(), "No registered evaluator for operation ${op}", ("op",op) );
    unique_ptr<op_evaluator>& eval = _operation_evaluators[ u_which ];
    FC_ASSERT( eval, "No registered evaluator for operation ${op}", ("op",op) );
+   chain_profiler::scoped_timer timer( _profiler.get(), i_which, chain_profiler::phase_total );
    auto op_id = push_applied_operation( op );
    auto result = eval->evaluate( eval_state, op, true );
    set_applied_operation_result( op_id, result );
@@ -797,6 +1011,62 @@ bool database::before_last_checkpoint()const
 static const uint32_t skip_expensive = database::skip_transaction_signatures | database::skip_witness_signature
                                        | database::skip_merkle_check | database::skip_transaction_dupe_check;
 
+namespace detail {
+
+   /// Only transactions in blocks are leaves of a merkle tree
+   void precompute_merkle_digest( const processed_transaction& trx ) { trx.merkle_digest(); }
+   void precompute_merkle_digest( const precomputable_transaction& ) {}
+
+   /// Relative cost of precomputing a transaction, recovering a public key outweighs everything else
+   uint64_t precompute_weight( const precomputable_transaction& trx, const uint32_t skip )
+   {
+      if( (skip & database::skip_transaction_signatures) || trx.has_signature_keys() )
+         return 1;
+      return 1 + 10 * trx.signatures.size();
+   }
+
+} // detail
+
+uint32_t database::reuse_recovered_signature_keys( const signed_block& block )const
+{
+   uint32_t reused = 0;
+   std::lock_guard<std::mutex> guard( _recovered_signature_keys_mutex );
+   if( _recovered_signature_keys.empty() )
+      return reused;
+   const auto& by_id = _recovered_signature_keys.get<by_trx_id>();
+   for( const processed_transaction& trx : block.transactions )
+   {
+      auto itr = by_id.find( trx.id() );
+      if( itr != by_id.end() && trx.reuse_signature_keys( itr->signatures, itr->keys ) )
+         ++reused;
+   }
+   return reused;
+}
+
+void database::_remember_signature_keys( const precomputable_transaction& trx )
+{
+   if( !trx.has_signature_keys() )
+      return;
+   std::lock_guard<std::mutex> guard( _recovered_signature_keys_mutex );
+   auto& by_id = _recovered_signature_keys.get<by_trx_id>();
+   if( by_id.find( trx.id() ) != by_id.end() )
+      return;
+   by_id.insert( recovered_signature_keys{ trx.id(), trx.expiration, trx.signatures,
+                                           trx.get_signature_keys( get_chain_id() ) } );
+}
+
+void database::_forget_signature_keys( const signed_block& applied_block )
+{
+   std::lock_guard<std::mutex> guard( _recovered_signature_keys_mutex );
+   if( _recovered_signature_keys.empty() )
+      return;
+   auto& by_id = _recovered_signature_keys.get<by_trx_id>();
+   for( const processed_transaction& trx : applied_block.transactions )
+      by_id.erase( trx.id() );
+   auto& by_exp = _recovered_signature_keys.get<by_expiration>();
+   by_exp.erase( by_exp.begin(), by_exp.lower_bound( head_block_time() ) );
+}
+
 template<typename Trx>
 void database::_precompute_parallel( const Trx* trx, const size_t count, const uint32_t skip )const
 {
@@ -805,10 +1075,28 @@ void database::_precompute_parallel( const Trx* trx, const size_t count, const u
       trx->validate(); // TODO - parallelize wrt confidential operations
       if ( !(skip & skip_block_size_check) )
          trx->get_packed_size();
+      // hash HTLC preimages here so that redeem evaluation only has to compare
+      if( !(skip&skip_transaction_signatures) )
+      {
+         for( const operation& op : trx->operations )
+         {
+            if( !op.is_type< htlc_redeem_operation >() )
+               continue;
+            const auto& redeem = op.get< htlc_redeem_operation >();
+            const auto algorithm = get_index_type< primary_index< htlc_index > >()
+                                      .get_secondary_index< htlc_hash_algorithm_index >()
+                                      .get_algorithm( redeem.htlc_id );
+            // unknown HTLCs are left to the evaluator, which rejects them
+            if( algorithm.valid() )
+               redeem.precompute_preimage_hash( *algorithm );
+         }
+      }
       if( !(skip&skip_transaction_dupe_check) )
          trx->id();
       if( !(skip&skip_transaction_signatures) )
          trx->get_signature_keys( get_chain_id() );
+      if( !(skip&skip_merkle_check) )
+         detail::precompute_merkle_digest( *trx );
    }
 }
 
@@ -821,22 +1109,45 @@ fc::future<void> database::precompute_parallel( const signed_block& block, const
          _precompute_parallel( &block.transactions[0], block.transactions.size(), skip );
       else
       {
+         // transactions which were pending here already had their signature keys recovered
+         if( !(skip&skip_transaction_signatures) )
+            reuse_recovered_signature_keys( block );
+
+         // balance the chunks by the work left, mostly the number of signatures to recover
          uint32_t chunks = fc::asio::default_io_service_scope::get_num_threads();
-         uint32_t chunk_size = ( block.transactions.size() + chunks - 1 ) / chunks;
+         uint64_t total_weight = 0;
+         for( const auto& trx : block.transactions )
+            total_weight += detail::precompute_weight( trx, skip );
+         const uint64_t chunk_weight = ( total_weight + chunks - 1 ) / chunks;
          workers.reserve( chunks + 1 );
-         for( size_t base = 0; base < block.transactions.size(); base += chunk_size )
-            workers.push_back( fc::do_parallel( [this,&block,base,chunk_size,skip] () {
-               _precompute_parallel( &block.transactions[base],
-                                     base + chunk_size < block.transactions.size() ? chunk_size : block.transactions.size() - base,
-                                     skip );
+         size_t base = 0;
+         uint64_t weight = 0;
+         for( size_t i = 0; i < block.transactions.size(); ++i )
+         {
+            weight += detail::precompute_weight( block.transactions[i], skip );
+            if( weight < chunk_weight && i + 1 < block.transactions.size() )
+               continue;
+            const size_t count = i + 1 - base;
+            workers.push_back( fc::do_parallel( [this,&block,base,count,skip] () {
+               _precompute_parallel( &block.transactions[base], count, skip );
             }) );
+            base = i + 1;
+            weight = 0;
+         }
       }
    }
 
+   const size_t transaction_workers = workers.size();
    if( !(skip&skip_witness_signature) )
       workers.push_back( fc::do_parallel( [&block] () { block.signee(); } ) );
+
    if( !(skip&skip_merkle_check) )
+   {
+      // the transaction workers hash the leaves, the tree is built from them afterwards
+      for( size_t i = 0; i < transaction_workers; ++i )
+         workers[i].wait();
       block.calculate_merkle_root();
+   }
    block.id();
 
    if( workers.empty() )
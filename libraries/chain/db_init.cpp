@@ -167,7 +167,8 @@ void database::initialize_indexes()
    add_index< primary_index<worker_index> >();
    add_index< primary_index<balance_index> >();
    add_index< primary_index<ico_balance_index> >();
-   add_index< primary_index< htlc_index> >();
+   auto htlc_idx = add_index< primary_index< htlc_index> >();
+   htlc_idx->add_secondary_index<htlc_hash_algorithm_index>();
    add_index< primary_index< custom_authority_index> >();
    add_index< primary_index<ticket_index> >();
 
@@ -176,6 +177,8 @@ void database::initialize_indexes()
 
    auto bal_idx = add_index< primary_index<account_balance_index          > >();
    bal_idx->add_secondary_index<balances_by_account_index>();
+   bal_idx->add_secondary_index<balances_by_asset_index>();
+   bal_idx->add_secondary_index<balances_to_maintain_index>();
 
    add_index< primary_index<asset_bitasset_data_index,                 13 > >(); // 8192
    add_index< primary_index<simple_index<global_property_object          >> >();
@@ -408,6 +411,12 @@ void database::init_genesis(const genesis_state_type& genesis_state)
       create<block_summary_object>( [&]( block_summary_object&) {});
 
    // Create initial accounts
+   // Every account creation and upgrade is recorded in _applied_ops, size it once for large genesis states
+   _applied_ops.reserve( _applied_ops.size() + genesis_state.initial_accounts.size()
+                         + std::count_if( genesis_state.initial_accounts.begin(), genesis_state.initial_accounts.end(),
+                                          []( const genesis_state_type::initial_account_type& a ) {
+                                             return a.is_lifetime_member;
+                                          } ) );
    for( const auto& account : genesis_state.initial_accounts )
    {
       account_create_operation cop;
@@ -436,7 +445,7 @@ void database::init_genesis(const genesis_state_type& genesis_state)
    }
 
    // Helper function to get account ID by name
-   const auto& accounts_by_name = get_index_type<account_index>().indices().get<by_name>();
+   const auto& accounts_by_name = get_index_type<account_index>().indices().get<by_name_hash>();
    auto get_account_id = [&accounts_by_name](const string& name) {
       auto itr = accounts_by_name.find(name);
       FC_ASSERT(itr != accounts_by_name.end(),
@@ -675,7 +684,7 @@ void database::init_genesis(const genesis_state_type& genesis_state)
    _p_witness_schedule_obj = & create<witness_schedule_object>([this]( witness_schedule_object& wso )
    {
       for( const witness_id_type& wid : get_global_properties().active_witnesses )
-         wso.current_shuffled_witnesses.push_back( wid );
+         wso.current_witnesses.push_back( wid );
    });
 
    // Create FBA counters
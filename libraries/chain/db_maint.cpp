@@ -27,6 +27,7 @@
 #include <fc/uint128.hpp>
 
 #include <graphene/chain/database.hpp>
+#include <graphene/chain/db_with.hpp>
 #include <graphene/chain/fba_accumulator_id.hpp>
 #include <graphene/chain/hardfork.hpp>
 
@@ -76,24 +77,20 @@ vector<std::reference_wrapper<const typename Index::object_type>> database::sort
 template<class Type>
 void database::perform_account_maintenance(Type tally_helper)
 {
-   const auto& bal_idx = get_index_type< account_balance_index >().indices().get< by_maintenance_flag >();
-   if( bal_idx.begin() != bal_idx.end() )
+   // Each flagged balance updates the statistics of a different account, so the order does not matter
+   const auto& bal_idx = get_index_type< primary_index< account_balance_index > >();
+   for( const account_balance_id_type& bal_id : bal_idx.get_secondary_index< balances_to_maintain_index >()
+                                                        .get_flagged_balances() )
    {
-      auto bal_itr = bal_idx.rbegin();
-      while( bal_itr->maintenance_flag )
-      {
-         const account_balance_object& bal_obj = *bal_itr;
-
-         modify( get_account_stats_by_owner( bal_obj.owner ), [&bal_obj](account_statistics_object& aso) {
-            aso.core_in_balance = bal_obj.balance;
-         });
+      const account_balance_object& bal_obj = bal_id( *this );
 
-         modify( bal_obj, []( account_balance_object& abo ) {
-            abo.maintenance_flag = false;
-         });
+      modify( get_account_stats_by_owner( bal_obj.owner ), [&bal_obj](account_statistics_object& aso) {
+         aso.core_in_balance = bal_obj.balance;
+      });
 
-         bal_itr = bal_idx.rbegin();
-      }
+      modify( bal_obj, []( account_balance_object& abo ) {
+         abo.maintenance_flag = false;
+      });
    }
 
    const auto& stats_idx = get_index_type< account_stats_index >().indices().get< by_maintenance_seq >();
@@ -634,6 +631,9 @@ void visit_special_authorities( const database& db, Visitor visit )
 
 void update_top_n_authorities( database& db )
 {
+   const auto& bal_idx = db.get_index_type< primary_index< account_balance_index > >();
+   const auto& holders_idx = bal_idx.get_secondary_index< balances_by_asset_index >();
+   flat_set< asset_id_type > used_assets;
    visit_special_authorities( db,
    [&]( const account_object& acct, bool is_owner, const special_authority& auth )
    {
@@ -643,40 +643,57 @@ void update_top_n_authorities( database& db )
 
          const top_holders_special_authority& tha = auth.get< top_holders_special_authority >();
          vote_counter vc;
-         const auto& bal_idx = db.get_index_type< account_balance_index >().indices().get< by_asset_balance >();
          uint8_t num_needed = tha.num_top_holders;
          if( num_needed == 0 )
             return;
 
          // find accounts
-         const auto range = bal_idx.equal_range( boost::make_tuple( tha.asset ) );
-         for( const account_balance_object& bal : boost::make_iterator_range( range.first, range.second ) )
+         used_assets.insert( tha.asset );
+         const auto& holders = holders_idx.get_holders( tha.asset, bal_idx );
+         for( const balance_holder& holder : holders )
          {
-             assert( bal.asset_type == tha.asset );
-             if( bal.owner == acct.id )
+             if( holder.owner == acct.id )
                 continue;
-             vc.add( bal.owner, bal.balance.value );
+             vc.add( holder.owner, holder.balance.value );
              --num_needed;
              if( num_needed == 0 )
                 break;
          }
 
+         // finish() leaves the account alone without any holder
+         if( vc.is_empty() )
+            return;
+
+         // only rewrite the authority when the top holders or their weights changed
+         const uint8_t control_flag = is_owner ? account_object::top_n_control_owner
+                                               : account_object::top_n_control_active;
+         authority new_auth;
+         vc.finish( new_auth );
+         if( ( acct.top_n_control_flags & control_flag ) && new_auth == ( is_owner ? acct.owner : acct.active ) )
+            return;
+
          db.modify( acct, [&]( account_object& a )
          {
-            vc.finish( is_owner ? a.owner : a.active );
-            if( !vc.is_empty() )
-               a.top_n_control_flags |= (is_owner ? account_object::top_n_control_owner : account_object::top_n_control_active);
+            ( is_owner ? a.owner : a.active ) = std::move( new_auth );
+            a.top_n_control_flags |= control_flag;
          } );
       }
    } );
+   // assets no authority refers to any more need not be kept sorted
+   holders_idx.retain_assets( used_assets );
 }
 
+/**
+ * Pays out the accumulated fees of an FBA accumulator. The network share is added to @p network_amount_total
+ * instead of being taken out of the core supply right away, see @ref distribute_fba_balances.
+ */
 void split_fba_balance(
    database& db,
    uint64_t fba_id,
    uint16_t network_pct,
    uint16_t designated_asset_buyback_pct,
-   uint16_t designated_asset_issuer_pct
+   uint16_t designated_asset_issuer_pct,
+   share_type& network_amount_total
 )
 {
    FC_ASSERT( uint32_t(network_pct) + uint32_t(designated_asset_buyback_pct) + uint32_t(designated_asset_issuer_pct) == GRAPHENE_100_PERCENT );
@@ -684,15 +701,10 @@ void split_fba_balance(
    if( fba.accumulated_fba_fees == 0 )
       return;
 
-   const asset_dynamic_data_object& core_dd = db.get_core_dynamic_data();
-
    if( !fba.is_configured(db) )
    {
       ilog( "${n} core given to network at block ${b} due to non-configured FBA", ("n", fba.accumulated_fba_fees)("b", db.head_block_time()) );
-      db.modify( core_dd, [&]( asset_dynamic_data_object& _core_dd )
-      {
-         _core_dd.current_supply -= fba.accumulated_fba_fees;
-      } );
+      network_amount_total += fba.accumulated_fba_fees;
       db.modify( fba, [&]( fba_accumulator_object& _fba )
       {
          _fba.accumulated_fba_fees = 0;
@@ -717,13 +729,7 @@ void split_fba_balance(
 
    const asset_object& designated_asset = (*fba.designated_asset)(db);
 
-   if( network_amount != 0 )
-   {
-      db.modify( core_dd, [&]( asset_dynamic_data_object& _core_dd )
-      {
-         _core_dd.current_supply -= network_amount;
-      } );
-   }
+   network_amount_total += network_amount;
 
    fba_distribute_operation vop;
    vop.account_id = *designated_asset.buyback_account;
@@ -752,9 +758,19 @@ void split_fba_balance(
 
 void distribute_fba_balances( database& db )
 {
-   split_fba_balance( db, fba_accumulator_id_transfer_to_blind  , 20*GRAPHENE_1_PERCENT, 60*GRAPHENE_1_PERCENT, 20*GRAPHENE_1_PERCENT );
-   split_fba_balance( db, fba_accumulator_id_blind_transfer     , 20*GRAPHENE_1_PERCENT, 60*GRAPHENE_1_PERCENT, 20*GRAPHENE_1_PERCENT );
-   split_fba_balance( db, fba_accumulator_id_transfer_from_blind, 20*GRAPHENE_1_PERCENT, 60*GRAPHENE_1_PERCENT, 20*GRAPHENE_1_PERCENT );
+   share_type network_amount;
+   split_fba_balance( db, fba_accumulator_id_transfer_to_blind  , 20*GRAPHENE_1_PERCENT, 60*GRAPHENE_1_PERCENT, 20*GRAPHENE_1_PERCENT, network_amount );
+   split_fba_balance( db, fba_accumulator_id_blind_transfer     , 20*GRAPHENE_1_PERCENT, 60*GRAPHENE_1_PERCENT, 20*GRAPHENE_1_PERCENT, network_amount );
+   split_fba_balance( db, fba_accumulator_id_transfer_from_blind, 20*GRAPHENE_1_PERCENT, 60*GRAPHENE_1_PERCENT, 20*GRAPHENE_1_PERCENT, network_amount );
+
+   // nothing above reads the core supply, so the network shares are taken out of it at once
+   if( network_amount != 0 )
+   {
+      db.modify( db.get_core_dynamic_data(), [network_amount]( asset_dynamic_data_object& _core_dd )
+      {
+         _core_dd.current_supply -= network_amount;
+      } );
+   }
 }
 
 void create_buyback_orders( database& db )
@@ -901,16 +917,17 @@ void database::process_bitassets()
 void update_median_feeds(database& db)
 {
    time_point_sec head_time = db.head_block_time();
-   time_point_sec next_maint_time = db.get_dynamic_global_properties().next_maintenance_time;
-
-   const auto update_bitasset = [head_time, next_maint_time]( asset_bitasset_data_object &o )
-   {
-      o.update_median_feeds( head_time, next_maint_time );
-   };
 
    for( const auto& d : db.get_index_type<asset_bitasset_data_index>().indices() )
    {
-      db.modify( d, update_bitasset );
+      // most bitassets come out unchanged, only modify (and so copy into undo) those which do not
+      const auto result = d.calculate_median_feeds( head_time );
+      if( !d.median_feeds_changed( result ) )
+         continue;
+      db.modify( d, [&result]( asset_bitasset_data_object& o )
+      {
+         o.apply_median_feeds( result );
+      });
    }
 }
 
@@ -927,6 +944,63 @@ void delete_expired_custom_authorities( database& db )
 
 namespace detail {
 
+   /// Fills a @ref maintenance_report one phase at a time
+   class maintenance_phase_recorder
+   {
+      public:
+         maintenance_phase_recorder( const graphene::db::undo_database& undo, uint32_t block_num,
+                                     maintenance_report& report )
+         : _undo( undo ), _report( report ), _start( fc::time_point::now() ), _phase_start( _start )
+         {
+            _report = maintenance_report();
+            _report.block_num = block_num;
+            get_undo_sizes( _created, _modified, _removed );
+         }
+
+         void end_phase( const char* name )
+         {
+            const fc::time_point now = fc::time_point::now();
+            maintenance_phase_report phase;
+            phase.name = name;
+            phase.time_us = ( now - _phase_start ).count();
+            uint64_t created, modified, removed;
+            get_undo_sizes( created, modified, removed );
+            phase.objects_created  = created  - _created;
+            phase.objects_modified = modified - _modified;
+            phase.objects_removed  = removed  - _removed;
+            _report.phases.push_back( std::move( phase ) );
+            _created  = created;
+            _modified = modified;
+            _removed  = removed;
+            _phase_start = now;
+         }
+
+         void finish()
+         {
+            _report.total_us = ( fc::time_point::now() - _start ).count();
+         }
+
+      private:
+         void get_undo_sizes( uint64_t& created, uint64_t& modified, uint64_t& removed )const
+         {
+            created = modified = removed = 0;
+            if( !_undo.enabled() || _undo.size() == 0 )
+               return;
+            const auto& state = _undo.head();
+            created  = state.new_ids.size();
+            modified = state.old_values.size();
+            removed  = state.removed.size();
+         }
+
+         const graphene::db::undo_database&   _undo;
+         maintenance_report&                  _report;
+         const fc::time_point                 _start;
+         fc::time_point                       _phase_start;
+         uint64_t                             _created  = 0;
+         uint64_t                             _modified = 0;
+         uint64_t                             _removed  = 0;
+   };
+
    struct vote_recalc_times
    {
       time_point_sec full_power_time;
@@ -1004,8 +1078,13 @@ void database::perform_chain_maintenance(const signed_block& next_block, const g
    const auto& gpo = get_global_properties();
    const auto& dgpo = get_dynamic_global_properties();
 
+   // time the phases, so that the slow ones show up in the log
+   detail::maintenance_phase_recorder recorder( _undo_db, next_block.block_num(), _last_maintenance_report );
+
    distribute_fba_balances(*this);
+   recorder.end_phase( "fba" );
    create_buyback_orders(*this);
+   recorder.end_phase( "buyback" );
 
    struct vote_tally_helper {
       database& d;
@@ -1187,6 +1266,7 @@ void database::perform_chain_maintenance(const signed_block& next_block, const g
    } tally_helper(*this);
 
    perform_account_maintenance( tally_helper );
+   recorder.end_phase( "accounts" );
 
    struct clear_canary {
       clear_canary(vector<uint64_t>& target): target(target){}
@@ -1200,9 +1280,11 @@ void database::perform_chain_maintenance(const signed_block& next_block, const g
                 d(_cm_vote_for_worker_buffer);
 
    update_top_n_authorities(*this);
+   recorder.end_phase( "top_n" );
    update_active_witnesses();
    update_active_committee_members();
    update_worker_votes();
+   recorder.end_phase( "votes" );
 
    modify(gpo, [&dgpo](global_property_object& p) {
       // Remove scaling of account registration fee
@@ -1252,19 +1334,77 @@ void database::perform_chain_maintenance(const signed_block& next_block, const g
    });
 
    process_bitassets();
+   recorder.end_phase( "bitassets" );
    delete_expired_custom_authorities(*this);
 
    // process_budget needs to run at the bottom because
    //   it needs to know the next_maintenance_time
    process_budget();
+   recorder.end_phase( "budget" );
 
    for (vector<account_id_type>& at: _cm_support_worker_buffer)
    {
       at.clear();
    }
    _cm_support_worker_buffer.clear();
+
+   // warn when maintenance takes more than half of a block interval
+   recorder.finish();
+   if( _last_maintenance_report.total_us > uint64_t( gpo.parameters.block_interval ) * 500000 )
+      wlog( "Maintenance took ${t}us: ${r}", ("t",_last_maintenance_report.total_us)("r",_last_maintenance_report) );
+   else
+      dlog( "Maintenance took ${t}us: ${r}", ("t",_last_maintenance_report.total_us)("r",_last_maintenance_report) );
 }
 
+maintenance_report database::dry_run_maintenance()
+{ try {
+   FC_ASSERT( _undo_db.enabled(), "Maintenance can not be dry run while the undo database is disabled" );
+
+   signed_block next_block;
+   next_block.previous = head_block_id();
+   next_block.timestamp = std::max( get_dynamic_global_properties().next_maintenance_time,
+                                    head_block_time() + get_global_properties().parameters.block_interval );
+
+   // virtual operations and their counters belong to the last block
+   const auto applied_ops = _applied_ops;
+   const auto current_block_num = _current_block_num;
+   const auto current_trx_in_block = _current_trx_in_block;
+   const auto current_op_in_trx = _current_op_in_trx;
+   const auto current_virtual_op = _current_virtual_op;
+   const maintenance_report last_report = _last_maintenance_report;
+   // the seed is not in the undo database, but commits and reveals are checked against it
+   const maintenance_prng prng = _maintenance_prng;
+   const auto restore = [&]()
+   {
+      _maintenance_prng = prng;
+      _applied_ops = applied_ops;
+      _current_block_num = current_block_num;
+      _current_trx_in_block = current_trx_in_block;
+      _current_op_in_trx = current_op_in_trx;
+      _current_virtual_op = current_virtual_op;
+      _last_maintenance_report = last_report;
+   };
+
+   maintenance_report report;
+   detail::without_pending_transactions( *this, std::move(_pending_tx), [&]()
+   {
+      auto session = _undo_db.start_undo_session();
+      try
+      {
+         perform_chain_maintenance( next_block, get_global_properties() );
+      }
+      catch( ... )
+      {
+         restore();
+         throw;
+      }
+      report = _last_maintenance_report;
+      restore();
+      // the session is undone when it goes out of scope
+   });
+   return report;
+} FC_CAPTURE_AND_RETHROW() }
+
 void database::maintenance_prng::seed(uint64_t seed)
 {
    _seed = seed;
@@ -53,6 +53,14 @@ database::~database()
    clear_pending();
 }
 
+void database::enable_profiling( bool enable )
+{
+   if( !enable )
+      _profiler.reset();
+   else if( !_profiler )
+      _profiler = std::make_unique<chain_profiler>();
+}
+
 void database::reindex( fc::path data_dir )
 { try {
    auto last_block = _block_id_to_block.last();
@@ -161,6 +169,8 @@ void database::reindex( fc::path data_dir )
    _undo_db.enable();
    auto end = fc::time_point::now();
    ilog( "Done reindexing, elapsed time: ${t} sec", ("t",double((end-start).count())/1000000.0 ) );
+   if( _profiler )
+      _profiler->log_report();
 } FC_CAPTURE_AND_RETHROW( (data_dir) ) }
 
 void database::wipe(const fc::path& data_dir, bool include_blocks)
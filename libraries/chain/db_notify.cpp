@@ -499,13 +499,10 @@ void get_relevant_accounts( const object* obj, flat_set<account_id_type>& accoun
               FC_ASSERT( aobj != nullptr );
               accounts.insert( aobj->owner );
               break;
-           } case impl_transaction_history_object_type:{
-              const auto& aobj = dynamic_cast<const transaction_history_object*>(obj);
-              FC_ASSERT( aobj != nullptr );
-              transaction_get_impacted_accounts( aobj->trx, accounts,
-                                                 ignore_custom_operation_required_auths );
+           } case impl_transaction_history_object_type:
+              // only holds the transaction ID, the accounts are notified through the objects the operations touch
               break;
-           } case impl_block_summary_object_type:
+             case impl_block_summary_object_type:
               break;
              case impl_account_transaction_history_object_type: {
               const auto& aobj = dynamic_cast<const account_transaction_history_object*>(obj);
@@ -543,15 +540,19 @@ void database::notify_changed_objects()
    if( _undo_db.enabled() ) 
    {
       const auto& head_undo = _undo_db.head();
+      const bool subscribed = ( _impacted_accounts_subscribers > 0 );
 
       // New
       if( !new_objects.empty() )
       {
         vector<object_id_type> new_ids;  new_ids.reserve(head_undo.new_ids.size());
         flat_set<account_id_type> new_accounts_impacted;
+        const bool need_accounts = subscribed || new_objects.num_slots() > *_new_objects_without_accounts;
         for( const auto& item : head_undo.new_ids )
         {
           new_ids.push_back(item);
+          if( !need_accounts )
+            continue;
           auto obj = find_object(item);
           if(obj != nullptr)
             get_relevant_accounts(obj, new_accounts_impacted, false);
@@ -566,10 +567,12 @@ void database::notify_changed_objects()
       {
         vector<object_id_type> changed_ids;  changed_ids.reserve(head_undo.old_values.size());
         flat_set<account_id_type> changed_accounts_impacted;
+        const bool need_accounts = subscribed || changed_objects.num_slots() > *_changed_objects_without_accounts;
         for( const auto& item : head_undo.old_values )
         {
           changed_ids.push_back(item.first);
-          get_relevant_accounts(item.second.get(), changed_accounts_impacted, false);
+          if( need_accounts )
+            get_relevant_accounts(item.second.get(), changed_accounts_impacted, false);
         }
 
         if( changed_ids.size() )
@@ -582,12 +585,14 @@ void database::notify_changed_objects()
         vector<object_id_type> removed_ids; removed_ids.reserve( head_undo.removed.size() );
         vector<const object*> removed; removed.reserve( head_undo.removed.size() );
         flat_set<account_id_type> removed_accounts_impacted;
+        const bool need_accounts = subscribed || removed_objects.num_slots() > *_removed_objects_without_accounts;
         for( const auto& item : head_undo.removed )
         {
           removed_ids.emplace_back( item.first );
           auto obj = item.second.get();
           removed.emplace_back( obj );
-          get_relevant_accounts(obj, removed_accounts_impacted, false);
+          if( need_accounts )
+            get_relevant_accounts(obj, removed_accounts_impacted, false);
         }
 
         if( removed_ids.size() )
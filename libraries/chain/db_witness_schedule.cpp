@@ -33,12 +33,60 @@ namespace graphene { namespace chain {
 
 using boost::container::flat_set;
 
+namespace detail {
+
+   /// Shuffles the witnesses of a round, seeded by the time the round started
+   static void shuffle_witnesses( vector< witness_id_type >& witnesses, const time_point_sec round_start_time )
+   {
+      auto now_hi = uint64_t(round_start_time.sec_since_epoch()) << 32;
+      for( uint32_t i = 0; i < witnesses.size(); ++i )
+      {
+         /// High performance random generator
+         /// http://xorshift.di.unimi.it/
+         uint64_t k = now_hi + uint64_t(i)*2685821657736338717ULL;
+         k ^= (k >> 12);
+         k ^= (k << 25);
+         k ^= (k >> 27);
+         k *= 2685821657736338717ULL;
+
+         uint32_t jmax = witnesses.size() - i;
+         uint32_t j = i + k%jmax;
+         std::swap( witnesses[i], witnesses[j] );
+      }
+   }
+
+} // detail
+
+const vector< witness_id_type >& database::_get_shuffled_witnesses()const
+{
+   const witness_schedule_object& wso = get_witness_schedule_object();
+   const time_point_sec round_start_time = get_dynamic_global_properties().witness_round_start_time;
+   // also catches undone rounds, e.g. when switching forks
+   if( _shuffled_round_start_time != round_start_time || _shuffled_round_witnesses != wso.current_witnesses )
+   {
+      _shuffled_round_start_time = round_start_time;
+      _shuffled_round_witnesses = wso.current_witnesses;
+      _shuffled_witnesses = wso.current_witnesses;
+      // the first round after genesis is not shuffled
+      if( round_start_time != time_point_sec() )
+         detail::shuffle_witnesses( _shuffled_witnesses, round_start_time );
+   }
+   return _shuffled_witnesses;
+}
+
+vector< witness_id_type > database::get_shuffled_witnesses()const
+{
+   std::lock_guard< std::mutex > guard( _shuffled_witnesses_mutex );
+   return _get_shuffled_witnesses();
+}
+
 witness_id_type database::get_scheduled_witness( uint32_t slot_num )const
 {
    const dynamic_global_property_object& dpo = get_dynamic_global_properties();
-   const witness_schedule_object& wso = get_witness_schedule_object();
    uint64_t current_aslot = dpo.current_aslot + slot_num;
-   return wso.current_shuffled_witnesses[ current_aslot % wso.current_shuffled_witnesses.size() ];
+   std::lock_guard< std::mutex > guard( _shuffled_witnesses_mutex );
+   const vector< witness_id_type >& witnesses = _get_shuffled_witnesses();
+   return witnesses[ current_aslot % witnesses.size() ];
 }
 
 fc::time_point_sec database::get_slot_time(uint32_t slot_num)const
@@ -84,7 +132,7 @@ uint32_t database::update_witness_missed_blocks( const signed_block& b )
    uint32_t missed_blocks = get_slot_at_time( b.timestamp );
    FC_ASSERT( missed_blocks != 0, "Trying to push double-produced block onto current block?!" );
    missed_blocks--;
-   const auto& witnesses = witness_schedule_id_type()(*this).current_shuffled_witnesses;
+   const auto& witnesses = get_witness_schedule_object().current_witnesses;
    if( missed_blocks < witnesses.size() )
       for( uint32_t i = 0; i < missed_blocks; ++i ) {
          const auto& witness_missed = get_scheduled_witness( i+1 )(*this);
@@ -103,36 +151,28 @@ uint32_t database::witness_participation_rate()const
 
 void database::update_witness_schedule()
 {
-   const witness_schedule_object& wso = get_witness_schedule_object();
    const global_property_object& gpo = get_global_properties();
 
    if( head_block_num() % gpo.active_witnesses.size() == 0 )
    {
-      modify( wso, [&]( witness_schedule_object& _wso )
+      // the shuffle of the new round follows from its start time, see get_shuffled_witnesses()
+      const time_point_sec round_start_time = head_block_time();
+      modify( get_dynamic_global_properties(), [&round_start_time]( dynamic_global_property_object& dpo )
       {
-         _wso.current_shuffled_witnesses.clear();
-         _wso.current_shuffled_witnesses.reserve( gpo.active_witnesses.size() );
-
-         for( const witness_id_type& w : gpo.active_witnesses )
-            _wso.current_shuffled_witnesses.push_back( w );
+         dpo.witness_round_start_time = round_start_time;
+      });
 
-         auto now_hi = uint64_t(head_block_time().sec_since_epoch()) << 32;
-         for( uint32_t i = 0; i < _wso.current_shuffled_witnesses.size(); ++i )
+      // the schedule object is only written when the active witnesses change
+      const witness_schedule_object& wso = get_witness_schedule_object();
+      if( wso.current_witnesses.size() != gpo.active_witnesses.size()
+            || !std::equal( wso.current_witnesses.begin(), wso.current_witnesses.end(),
+                            gpo.active_witnesses.begin() ) )
+      {
+         modify( wso, [&gpo]( witness_schedule_object& _wso )
          {
-            /// High performance random generator
-            /// http://xorshift.di.unimi.it/
-            uint64_t k = now_hi + uint64_t(i)*2685821657736338717ULL;
-            k ^= (k >> 12);
-            k ^= (k << 25);
-            k ^= (k >> 27);
-            k *= 2685821657736338717ULL;
-
-            uint32_t jmax = _wso.current_shuffled_witnesses.size() - i;
-            uint32_t j = i + k%jmax;
-            std::swap( _wso.current_shuffled_witnesses[i],
-                       _wso.current_shuffled_witnesses[j] );
-         }
-      });
+            _wso.current_witnesses.assign( gpo.active_witnesses.begin(), gpo.active_witnesses.end() );
+         });
+      }
    }
 }
 
@@ -40,6 +40,7 @@ database& generic_evaluator::db()const { return trx_state->db(); }
    operation_result generic_evaluator::start_evaluate( transaction_evaluation_state& eval_state, const operation& op, bool apply )
    { try {
       trx_state   = &eval_state;
+      _profiler   = eval_state.db().get_profiler();
       //check_required_authorities(op);
       auto result = evaluate( op );
 
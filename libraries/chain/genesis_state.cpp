@@ -26,10 +26,194 @@
 #include <graphene/chain/genesis_state.hpp>
 #include <graphene/protocol/fee_schedule.hpp>
 
+#include <fc/io/json.hpp>
 #include <fc/io/raw.hpp>
+#include <fc/thread/parallel.hpp>
+#include <fc/variant_object.hpp>
+
+namespace {
+
+/// A [begin,end) slice of the genesis JSON text
+typedef std::pair<const char*, const char*> json_range;
+
+/**
+ * Minimal scanner used to split the genesis JSON into its top-level members and the elements of its
+ * large arrays without materializing the whole document. It only finds value boundaries, the actual
+ * parsing of every slice is left to fc::json. Returns false on anything it does not understand, in
+ * which case the caller falls back to parsing the document in one go.
+ */
+class genesis_json_scanner
+{
+public:
+   genesis_json_scanner( const char* begin, const char* end ) : _pos(begin), _end(end) {}
+
+   void skip_whitespace()
+   {
+      while( _pos < _end && ( *_pos == ' ' || *_pos == '\t' || *_pos == '\n' || *_pos == '\r' ) )
+         ++_pos;
+   }
+
+   bool consume( char c )
+   {
+      skip_whitespace();
+      if( _pos >= _end || *_pos != c )
+         return false;
+      ++_pos;
+      return true;
+   }
+
+   bool peek( char c )
+   {
+      skip_whitespace();
+      return _pos < _end && *_pos == c;
+   }
+
+   bool at_end()
+   {
+      skip_whitespace();
+      return _pos >= _end;
+   }
+
+   /// Reads a member name, names containing escape sequences are not supported
+   bool read_key( std::string& key )
+   {
+      skip_whitespace();
+      if( _pos >= _end || *_pos != '"' )
+         return false;
+      const char* start = ++_pos;
+      while( _pos < _end && *_pos != '"' )
+      {
+         if( *_pos == '\\' )
+            return false;
+         ++_pos;
+      }
+      if( _pos >= _end )
+         return false;
+      key.assign( start, _pos++ );
+      return true;
+   }
+
+   /// Skips over the next value and returns its extent
+   bool read_value( json_range& range )
+   {
+      skip_whitespace();
+      if( _pos >= _end )
+         return false;
+      range.first = _pos;
+      if( *_pos == '"' )
+      {
+         if( !skip_string() )
+            return false;
+      }
+      else if( *_pos == '{' || *_pos == '[' )
+      {
+         uint32_t depth = 0;
+         do
+         {
+            if( _pos >= _end )
+               return false;
+            switch( *_pos )
+            {
+            case '"':
+               if( !skip_string() )
+                  return false;
+               continue;
+            case '{': case '[':
+               ++depth;
+               break;
+            case '}': case ']':
+               --depth;
+               break;
+            default:
+               break;
+            }
+            ++_pos;
+         } while( depth > 0 );
+      }
+      else
+      {
+         while( _pos < _end && *_pos != ',' && *_pos != '}' && *_pos != ']'
+                && *_pos != ' ' && *_pos != '\t' && *_pos != '\n' && *_pos != '\r' )
+            ++_pos;
+      }
+      range.second = _pos;
+      return range.second > range.first;
+   }
+
+   /// Splits the array starting at the current position into its elements
+   bool read_array_elements( std::vector<json_range>& elements )
+   {
+      if( !consume( '[' ) )
+         return false;
+      if( consume( ']' ) )
+         return true;
+      do
+      {
+         json_range element;
+         if( !read_value( element ) )
+            return false;
+         elements.push_back( element );
+      } while( consume( ',' ) );
+      return consume( ']' );
+   }
+
+private:
+   bool skip_string()
+   {
+      ++_pos; // opening quote
+      while( _pos < _end && *_pos != '"' )
+      {
+         if( *_pos == '\\' )
+            ++_pos;
+         ++_pos;
+      }
+      if( _pos >= _end )
+         return false;
+      ++_pos; // closing quote
+      return true;
+   }
+
+   const char* _pos;
+   const char* _end;
+};
+
+} // anonymous namespace
 
 namespace graphene { namespace chain {
 
+namespace {
+
+/// Below this number of elements an array is converted on the calling thread
+static const size_t genesis_parallel_threshold = 10000;
+
+template<typename T>
+void parse_genesis_elements( vector<T>& result, const vector<json_range>& elements, uint32_t max_depth )
+{
+   result.resize( elements.size() );
+   auto parse_range = [&result, &elements, max_depth]( size_t begin, size_t end ) {
+      for( size_t i = begin; i < end; ++i )
+         result[i] = fc::json::from_string( string( elements[i].first, elements[i].second ) ).as<T>( max_depth );
+   };
+   if( elements.size() < genesis_parallel_threshold )
+   {
+      parse_range( 0, elements.size() );
+      return;
+   }
+
+   const size_t chunks = fc::asio::default_io_service_scope::get_num_threads();
+   const size_t chunk_size = ( elements.size() + chunks - 1 ) / chunks;
+   vector<fc::future<void>> workers;
+   workers.reserve( chunks );
+   for( size_t base = 0; base < elements.size(); base += chunk_size )
+      workers.push_back( fc::do_parallel( [&parse_range, &elements, base, chunk_size] () {
+         parse_range( base, std::min( base + chunk_size, elements.size() ) );
+      }) );
+   for( auto& worker : workers )
+      worker.wait();
+}
+
+} // anonymous namespace
+
 chain_id_type genesis_state_type::compute_chain_id() const
 {
    return initial_chain_id;
@@ -44,6 +228,58 @@ void genesis_state_type::override_witness_signing_keys( const std::string& new_k
    }
 }
 
+genesis_state_type genesis_state_type::from_json( const std::string& json, uint32_t max_depth )
+{ try {
+   FC_ASSERT( max_depth > 2, "Recursion depth exceeded" );
+
+   fc::mutable_variant_object members;
+   vector<json_range> accounts;
+   vector<json_range> balances;
+   vector<json_range> ico;
+   vector<json_range> vesting;
+
+   genesis_json_scanner scanner( json.data(), json.data() + json.size() );
+   bool scanned = scanner.consume( '{' );
+   if( scanned && !scanner.consume( '}' ) )
+   {
+      do
+      {
+         string key;
+         if( !scanner.read_key( key ) || !scanner.consume( ':' ) )
+            scanned = false;
+         else if( key == "initial_accounts" && scanner.peek( '[' ) )
+            scanned = scanner.read_array_elements( accounts );
+         else if( key == "initial_balances" && scanner.peek( '[' ) )
+            scanned = scanner.read_array_elements( balances );
+         else if( key == "ico_balances" && scanner.peek( '[' ) )
+            scanned = scanner.read_array_elements( ico );
+         else if( key == "initial_vesting_balances" && scanner.peek( '[' ) )
+            scanned = scanner.read_array_elements( vesting );
+         else
+         {
+            json_range value;
+            scanned = scanner.read_value( value );
+            if( scanned )
+               members( key, fc::json::from_string( string( value.first, value.second ) ) );
+         }
+      } while( scanned && scanner.consume( ',' ) );
+      scanned = scanned && scanner.consume( '}' );
+   }
+
+   if( !scanned || !scanner.at_end() )
+   {
+      // Let the regular parser produce a proper error message for malformed input
+      return fc::json::from_string( json ).as<genesis_state_type>( max_depth );
+   }
+
+   genesis_state_type result = fc::variant( std::move( members ) ).as<genesis_state_type>( max_depth );
+   parse_genesis_elements( result.initial_accounts, accounts, max_depth - 2 );
+   parse_genesis_elements( result.initial_balances, balances, max_depth - 2 );
+   parse_genesis_elements( result.ico_balances, ico, max_depth - 2 );
+   parse_genesis_elements( result.initial_vesting_balances, vesting, max_depth - 2 );
+   return result;
+} FC_CAPTURE_AND_RETHROW( (max_depth) ) }
+
 } } // graphene::chain
 
 FC_REFLECT_DERIVED_NO_TYPENAME(graphene::chain::genesis_state_type::initial_account_type, BOOST_PP_SEQ_NIL,
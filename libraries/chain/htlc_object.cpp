@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2018 jmjatlanta and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <graphene/chain/htlc_object.hpp>
+
+namespace graphene { namespace chain {
+
+void htlc_hash_algorithm_index::object_inserted( const object& obj )
+{
+   const auto& htlc = static_cast< const htlc_object& >( obj );
+   std::lock_guard<std::mutex> guard( mutex );
+   algorithms[ htlc_id_type( htlc.id ) ] = htlc.conditions.hash_lock.preimage_hash;
+}
+
+void htlc_hash_algorithm_index::object_removed( const object& obj )
+{
+   std::lock_guard<std::mutex> guard( mutex );
+   algorithms.erase( htlc_id_type( obj.id ) );
+}
+
+fc::optional<htlc_hash> htlc_hash_algorithm_index::get_algorithm( const htlc_id_type& htlc )const
+{
+   std::lock_guard<std::mutex> guard( mutex );
+   auto itr = algorithms.find( htlc );
+   if( itr == algorithms.end() )
+      return {};
+   return itr->second;
+}
+
+} } // graphene::chain
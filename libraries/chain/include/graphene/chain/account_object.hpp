@@ -27,7 +27,9 @@
 #include <graphene/db/generic_index.hpp>
 #include <graphene/protocol/account.hpp>
 
+#include <boost/container/small_vector.hpp>
 #include <boost/multi_index/composite_key.hpp>
+#include <boost/multi_index/hashed_index.hpp>
 
 namespace graphene { namespace chain {
    class database;
@@ -344,6 +346,34 @@ namespace graphene { namespace chain {
    };
 
 
+   /**
+    *  @brief The balance objects of one account, sorted by asset
+    *
+    *  Most accounts hold a handful of assets, so the entries live in a sorted array which stores the first few
+    *  inline.  That is cheaper to search and to update than a tree with one allocation per node, and unlike a
+    *  hash map it keeps iterating in asset order, which maintenance relies on.
+    */
+   class account_balance_map
+   {
+      public:
+         typedef std::pair< asset_id_type, const account_balance_object* > value_type;
+         typedef boost::container::small_vector< value_type, 2 >              container_type;
+         typedef container_type::const_iterator                              const_iterator;
+
+         const_iterator begin()const { return entries.begin(); }
+         const_iterator end()const   { return entries.end();   }
+         size_t         size()const  { return entries.size();  }
+         bool           empty()const { return entries.empty(); }
+
+         /// @return the balance object of @p asset, or nullptr
+         const account_balance_object* find( const asset_id_type& asset )const;
+         void set( const asset_id_type& asset, const account_balance_object* balance );
+         void erase( const asset_id_type& asset );
+
+      private:
+         container_type entries;
+   };
+
    /**
     *  @brief This secondary index will allow fast access to the balance objects
     *         that belonging to an account.
@@ -356,7 +386,7 @@ namespace graphene { namespace chain {
          virtual void about_to_modify( const object& before ) override;
          virtual void object_modified( const object& after  ) override;
 
-         const map< asset_id_type, const account_balance_object* >& get_account_balances( const account_id_type& acct )const;
+         const account_balance_map& get_account_balances( const account_id_type& acct )const;
          const account_balance_object* get_account_balance( const account_id_type& acct, const asset_id_type& asset )const;
 
       private:
@@ -364,34 +394,93 @@ namespace graphene { namespace chain {
          static const uint64_t mask;
 
          /** Maps each account to its balance objects */
-         vector< vector< map< asset_id_type, const account_balance_object* > > > balances;
+         vector< vector< account_balance_map > > balances;
          std::stack< object_id_type > ids_being_modified;
    };
 
-   struct by_asset_balance;
-   struct by_maintenance_flag;
+   /**
+    *  @brief The owner and amount of a balance, as kept by @ref balances_by_asset_index
+    */
+   struct balance_holder
+   {
+      share_type       balance;
+      account_id_type  owner;
+   };
+
+   /// Orders holders by balance descending, then by owner ascending
+   struct balance_holder_compare
+   {
+      bool operator()( const balance_holder& a, const balance_holder& b )const
+      {
+         return a.balance > b.balance || ( a.balance == b.balance && a.owner < b.owner );
+      }
+   };
+
+   typedef std::set< balance_holder, balance_holder_compare > balance_holder_set;
+
+   /**
+    *  @brief This secondary index keeps the holders of selected assets sorted by balance, for the top holders
+    *         special authorities.
+    *
+    *  Keeping every balance sorted would cost a tree update on each balance change, so an asset is only tracked
+    *  from the first call of @ref get_holders for it on, which scans the balance index once, until
+    *  @ref retain_assets drops it.
+    */
+   class balances_by_asset_index : public secondary_index
+   {
+      public:
+         virtual void object_inserted( const object& obj ) override;
+         virtual void object_removed( const object& obj ) override;
+         virtual void about_to_modify( const object& before ) override;
+         virtual void object_modified( const object& after  ) override;
+
+         /**
+          * @return the holders of @p asset including zero balances, largest balance first
+          * @param balances the primary balance index, scanned if @p asset is not tracked yet
+          */
+         const balance_holder_set& get_holders( const asset_id_type& asset, const index& balances )const;
+
+         /// Stop tracking the assets not in @p assets, e.g. once no top holders authority refers to them
+         void retain_assets( const flat_set< asset_id_type >& assets )const;
+
+      private:
+         /** Holders of the tracked assets, filled on demand */
+         mutable flat_map< asset_id_type, balance_holder_set > holders;
+   };
+
+   /**
+    *  @brief This secondary index tracks the balance objects whose @ref account_balance_object::maintenance_flag
+    *         is set, i.e. whose amount is copied to account_statistics_object::core_in_balance in the next
+    *         maintenance interval.
+    *
+    *  The flag itself stays in the balance object so that undo restores it, this index follows it through the
+    *  secondary index callbacks, which undo invokes as well.  Setting or clearing a flag flips one bit.
+    */
+   class balances_to_maintain_index : public secondary_index
+   {
+      public:
+         virtual void object_inserted( const object& obj ) override;
+         virtual void object_removed( const object& obj ) override;
+         virtual void object_modified( const object& after  ) override;
+
+         /// @return IDs of the flagged balance objects in ascending order
+         vector< account_balance_id_type > get_flagged_balances()const;
+
+      private:
+         void set_flagged( uint64_t instance, bool flagged );
+
+         /** One bit per balance object instance */
+         vector< uint64_t > flagged_bits;
+         size_t             flagged_count = 0;
+   };
+
    /**
     * @ingroup object_index
     */
    typedef multi_index_container<
       account_balance_object,
       indexed_by<
-         ordered_unique< tag<by_id>, member< object, object_id_type, &object::id > >,
-         ordered_non_unique< tag<by_maintenance_flag>,
-                             member< account_balance_object, bool, &account_balance_object::maintenance_flag > >,
-         ordered_unique< tag<by_asset_balance>,
-            composite_key<
-               account_balance_object,
-               member<account_balance_object, asset_id_type, &account_balance_object::asset_type>,
-               member<account_balance_object, share_type, &account_balance_object::balance>,
-               member<account_balance_object, account_id_type, &account_balance_object::owner>
-            >,
-            composite_key_compare<
-               std::less< asset_id_type >,
-               std::greater< share_type >,
-               std::less< account_id_type >
-            >
-         >
+         ordered_unique< tag<by_id>, member< object, object_id_type, &object::id > >
       >
    > account_balance_object_multi_index_type;
 
@@ -401,15 +490,20 @@ namespace graphene { namespace chain {
    typedef generic_index<account_balance_object, account_balance_object_multi_index_type> account_balance_index;
 
    struct by_name;
+   struct by_name_hash;
 
    /**
     * @ingroup object_index
+    *
+    * by_name serves range and prefix queries such as lookup_accounts, exact name lookups should use
+    * by_name_hash which avoids the string comparisons of a tree walk.
     */
    typedef multi_index_container<
       account_object,
       indexed_by<
          ordered_unique< tag<by_id>, member< object, object_id_type, &object::id > >,
-         ordered_unique< tag<by_name>, member<account_object, string, &account_object::name> >
+         ordered_unique< tag<by_name>, member<account_object, string, &account_object::name> >,
+         hashed_unique< tag<by_name_hash>, member<account_object, string, &account_object::name> >
       >
    > account_multi_index_type;
 
@@ -341,6 +341,24 @@ namespace graphene { namespace chain {
           * @param next_maintenance_time the next chain maintenance time
           */
          void update_median_feeds(time_point_sec current_time, time_point_sec next_maintenance_time);
+
+         /// Everything @ref update_median_feeds would write, see @ref calculate_median_feeds
+         struct median_feed_result
+         {
+            time_point_sec      publication_time;
+            price_feed_with_icr feed;
+            price               maintenance_collateralization;
+            price               initial_collateralization;
+            /// Whether at least options.minimum_feeds feeds were alive
+            bool                enough_feeds = false;
+         };
+
+         /// Calculate the median feed at @p current_time without modifying this object
+         median_feed_result calculate_median_feeds( time_point_sec current_time )const;
+         /// Whether applying @p result would modify this object
+         bool median_feeds_changed( const median_feed_result& result )const;
+         /// Store a result of @ref calculate_median_feeds
+         void apply_median_feeds( const median_feed_result& result );
    };
 
    // key extractor for short backing asset
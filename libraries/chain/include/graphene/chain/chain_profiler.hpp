@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2023 R-Squared Labs LLC, and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <fc/reflect/reflect.hpp>
+
+#include <array>
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace graphene { namespace chain {
+
+   struct chain_profile_report;
+
+   /**
+    * Opt-in accumulator of wall time spent in the hot paths of block application, used to find out which
+    * operation types, evaluator phases, block stages and signal observers dominate replay and sync.
+    *
+    * The database only owns a profiler while profiling is enabled, and every timing hook is a
+    * @ref scoped_timer that does nothing when given a null profiler, so the disabled cost is one branch.
+    */
+   class chain_profiler
+   {
+      public:
+         /// Phases of a single operation; @c total covers the whole of database::apply_operation()
+         enum evaluator_phase
+         {
+            phase_total,
+            phase_fee,       ///< prepare_fee(), the fee schedule check, convert_fee(), pay_fee() and the payer debit
+            phase_evaluate,  ///< do_evaluate()
+            phase_apply,     ///< do_apply()
+            PHASE_COUNT
+         };
+
+         /// Stages of database::_apply_block()
+         enum block_stage
+         {
+            stage_header,                  ///< size and merkle checks, validate_block_header()
+            stage_transactions,            ///< applying every transaction of the block
+            stage_authority,               ///< verify_authority(), a subset of stage_transactions
+            stage_witness_updates,         ///< missed blocks, dynamic global properties, signing witness, LIB
+            stage_tickets,                 ///< process_tickets()
+            stage_maintenance,             ///< perform_chain_maintenance()
+            stage_expirations,             ///< block summary, expired objects, feeds and core exchange rates
+            stage_schedule,                ///< maintenance flag, witness schedule and debug updates
+            stage_applied_block_notify,    ///< the applied_block signal
+            stage_changed_objects_notify,  ///< the new/changed/removed objects signals
+            STAGE_COUNT
+         };
+
+         struct counter
+         {
+            uint64_t count    = 0;
+            uint64_t total_ns = 0;
+            uint64_t max_ns   = 0;
+
+            void add( uint64_t ns )
+            {
+               ++count;
+               total_ns += ns;
+               if( ns > max_ns )
+                  max_ns = ns;
+            }
+         };
+
+         /**
+          * Adds the time between construction and destruction to a counter, if there is one.
+          */
+         class scoped_timer
+         {
+            public:
+               scoped_timer( chain_profiler* profiler, int64_t op_which, evaluator_phase phase )
+               : _counter( profiler ? &profiler->operation_counter( op_which, phase ) : nullptr )
+               {
+                  if( _counter )
+                     _start = std::chrono::steady_clock::now();
+               }
+               scoped_timer( chain_profiler* profiler, block_stage stage )
+               : _counter( profiler ? &profiler->stage_counter( stage ) : nullptr )
+               {
+                  if( _counter )
+                     _start = std::chrono::steady_clock::now();
+               }
+               scoped_timer( chain_profiler* profiler, const std::string& observer )
+               : _counter( profiler ? &profiler->observer_counter( observer ) : nullptr )
+               {
+                  if( _counter )
+                     _start = std::chrono::steady_clock::now();
+               }
+               ~scoped_timer()
+               {
+                  if( _counter )
+                     _counter->add( std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                       std::chrono::steady_clock::now() - _start ).count() );
+               }
+
+               scoped_timer( const scoped_timer& ) = delete;
+               scoped_timer& operator=( const scoped_timer& ) = delete;
+
+            private:
+               counter*                                _counter;
+               std::chrono::steady_clock::time_point   _start;
+         };
+
+         chain_profiler();
+
+         counter& operation_counter( int64_t op_which, evaluator_phase phase )
+         {
+            return _operations[ op_which ][ phase ];
+         }
+         counter& stage_counter( block_stage stage ) { return _stages[ stage ]; }
+         counter& observer_counter( const std::string& observer ) { return _observers[ observer ]; }
+
+         /// Counts an applied block, the unit of the per-block averages in the report
+         void count_block() { ++_blocks; }
+
+         void reset();
+
+         /// @return the accumulated counters, sorted by total time, operations that never ran are omitted
+         chain_profile_report get_report()const;
+
+         /// Writes the report to the log, one line per stage and per operation type
+         void log_report()const;
+
+      private:
+         uint64_t                                                   _blocks = 0;
+         std::vector< std::array< counter, PHASE_COUNT > >          _operations;
+         std::array< counter, STAGE_COUNT >                         _stages;
+         std::map< std::string, counter >                           _observers;
+         std::chrono::steady_clock::time_point                      _since;
+   };
+
+   struct chain_profile_counter
+   {
+      std::string name;
+      uint64_t    count    = 0;
+      uint64_t    total_us = 0;
+      uint64_t    max_us   = 0;
+   };
+
+   struct chain_profile_operation
+   {
+      std::string operation;
+      uint64_t    count       = 0;
+      uint64_t    total_us    = 0;
+      uint64_t    max_us      = 0;
+      uint64_t    fee_us      = 0;
+      uint64_t    evaluate_us = 0;
+      uint64_t    apply_us    = 0;
+   };
+
+   struct chain_profile_report
+   {
+      uint64_t                                blocks     = 0;
+      uint64_t                                elapsed_us = 0; ///< wall time since the profiler was enabled or reset
+      std::vector< chain_profile_counter >    stages;
+      std::vector< chain_profile_operation >  operations;
+      std::vector< chain_profile_counter >    observers;  ///< signal observers connected via database::observe()
+   };
+
+   /// Wall time and objects touched by one phase of database::perform_chain_maintenance()
+   struct maintenance_phase_report
+   {
+      std::string name;
+      uint64_t    time_us          = 0;
+      /// Objects created, modified or removed for the first time in the block by this phase,
+      /// always 0 while the undo database is disabled
+      uint64_t    objects_created  = 0;
+      uint64_t    objects_modified = 0;
+      uint64_t    objects_removed  = 0;
+   };
+
+   struct maintenance_report
+   {
+      uint32_t                                   block_num = 0;
+      uint64_t                                   total_us  = 0;
+      std::vector< maintenance_phase_report >    phases;
+   };
+
+} } // graphene::chain
+
+FC_REFLECT( graphene::chain::chain_profile_counter, (name)(count)(total_us)(max_us) )
+FC_REFLECT( graphene::chain::chain_profile_operation,
+            (operation)(count)(total_us)(max_us)(fee_us)(evaluate_us)(apply_us) )
+FC_REFLECT( graphene::chain::chain_profile_report, (blocks)(elapsed_us)(stages)(operations)(observers) )
+FC_REFLECT( graphene::chain::maintenance_phase_report,
+            (name)(time_us)(objects_created)(objects_modified)(objects_removed) )
+FC_REFLECT( graphene::chain::maintenance_report, (block_num)(total_us)(phases) )
@@ -33,7 +33,9 @@
 #include <graphene/chain/commit_reveal_object.hpp>
 #include <graphene/chain/fork_database.hpp>
 #include <graphene/chain/block_database.hpp>
+#include <graphene/chain/chain_profiler.hpp>
 #include <graphene/chain/genesis_state.hpp>
+#include <graphene/chain/pending_transactions.hpp>
 #include <graphene/chain/evaluator.hpp>
 
 #include <graphene/db/object_database.hpp>
@@ -43,7 +45,9 @@
 
 #include <fc/log/logger.hpp>
 
+#include <atomic>
 #include <map>
+#include <mutex>
 
 namespace graphene { namespace protocol { struct predicate_result; } }
 
@@ -138,7 +142,8 @@ namespace graphene { namespace chain {
          block_id_type              get_block_id_for_num( uint32_t block_num )const;
          optional<signed_block>     fetch_block_by_id( const block_id_type& id )const;
          optional<signed_block>     fetch_block_by_number( uint32_t num )const;
-         const signed_transaction&  get_recent_transaction( const transaction_id_type& trx_id )const;
+         /// @return a transaction which is pending or was included in a block and has not expired yet
+         signed_transaction         get_recent_transaction( const transaction_id_type& trx_id )const;
          std::vector<block_id_type> get_block_ids_on_fork(block_id_type head_of_fork) const;
 
          /**
@@ -154,7 +159,7 @@ namespace graphene { namespace chain {
          bool push_block( const signed_block& b, uint32_t skip = skip_nothing );
          processed_transaction push_transaction( const precomputable_transaction& trx, uint32_t skip = skip_nothing );
          bool _push_block( const signed_block& b );
-         processed_transaction _push_transaction( const precomputable_transaction& trx );
+         processed_transaction _push_transaction( const precomputable_transaction& trx, bool prechecked = false );
 
          ///@throws fc::exception if the proposed transaction fails to apply.
          processed_transaction push_proposal( const proposal_object& proposal );
@@ -184,7 +189,10 @@ namespace graphene { namespace chain {
           *  @return the op_id which can be used to set the result after it has finished being applied.
           */
          uint32_t  push_applied_operation( const operation& op );
+         /// Same as above, but takes over the operation, e.g. a virtual operation built for this call
+         uint32_t  push_applied_operation( operation&& op );
          void      set_applied_operation_result( uint32_t op_id, const operation_result& r );
+         void      set_applied_operation_result( uint32_t op_id, operation_result&& r );
          const vector<optional< operation_history_object > >& get_applied_operations()const;
 
          string to_pretty_string( const asset& a )const;
@@ -222,6 +230,45 @@ namespace graphene { namespace chain {
           */
          fc::signal<void(const vector<object_id_type>&, const vector<const object*>&, const flat_set<account_id_type>&)>  removed_objects;
 
+         /**
+          * Connects @p observer to @p signal, one of the signals above, under @p name.  While profiling is
+          * enabled the time spent in the observer is reported by the chain profiler under that name.
+          */
+         template<typename Signal, typename Observer>
+         boost::signals2::connection observe( Signal& signal, const std::string& name, Observer observer )
+         {
+            return signal.connect( [this,name,observer]( const auto&... args ) {
+               chain_profiler::scoped_timer timer( _profiler.get(), name );
+               observer( args... );
+            });
+         }
+
+         /**
+          * Like observe(), for an observer of new_objects, changed_objects or removed_objects which does not need
+          * the impacted accounts, or asks for them through subscribe_to_impacted_accounts() only when it does.
+          */
+         template<typename Signal, typename Observer>
+         boost::signals2::connection observe_without_impacted_accounts( Signal& signal, const std::string& name,
+                                                                        Observer observer )
+         {
+            std::shared_ptr< std::atomic<uint32_t> > count = _observers_without_impacted_accounts( signal );
+            ++*count;
+            // the slot, and with it the guard, is released when the observer is disconnected
+            std::shared_ptr<void> guard( nullptr, [count]( void* ) { --*count; } );
+            return observe( signal, name, [observer,guard]( const auto&... args ) { observer( args... ); } );
+         }
+
+         /**
+          * The impacted accounts passed to new_objects, changed_objects and removed_objects are computed while
+          * an observer connected with observe() is connected to the signal, or while at least one subscriber
+          * needs them, otherwise the sets are empty.  Every call to subscribe_to_impacted_accounts() must be
+          * paired with a call to unsubscribe_from_impacted_accounts().
+          */
+         ///@{
+         void subscribe_to_impacted_accounts()     { ++_impacted_accounts_subscribers; }
+         void unsubscribe_from_impacted_accounts() { --_impacted_accounts_subscribers; }
+         ///@}
+
          //////////////////// db_witness_schedule.cpp ////////////////////
 
          /**
@@ -240,6 +287,12 @@ namespace graphene { namespace chain {
           */
          witness_id_type get_scheduled_witness(uint32_t slot_num)const;
 
+         /**
+          * @return the witnesses of the current round in production order, i.e. the witnesses of the
+          *         witness_schedule_object shuffled by the start time of the round
+          */
+         vector< witness_id_type > get_shuffled_witnesses()const;
+
          /**
           * Get the time at which the given slot occurs.
           *
@@ -343,6 +396,12 @@ namespace graphene { namespace chain {
           * @return owner's balance in asset
           */
          asset get_market_fee_vesting_balance(const account_id_type &account_id, const asset_id_type &asset_id);
+         /**
+          * @brief Find the market fee sharing vesting balance object of an account in a given asset
+          * @return the object, or nullptr if the account has not received market fee rewards in that asset yet
+          */
+         const vesting_balance_object* find_market_fee_vesting_balance( const account_id_type& account_id,
+                                                                        const asset_id_type& asset_id )const;
 
          /**
           * @brief Helper to make lazy deposit to CDD VBO.
@@ -513,6 +572,13 @@ namespace graphene { namespace chain {
           */
          processed_transaction validate_transaction( const signed_transaction& trx );
 
+         /**
+          *  Rejects transactions which are duplicates, expired or refer to another fork, without starting an
+          *  undo session.  Performs the same checks as applying the transaction would.  push_transaction() runs
+          *  these once before opening its undo session, and does not repeat them while applying.
+          */
+         void precheck_transaction( const signed_transaction& trx )const;
+
 
          /** when popping a block, the transactions that were removed get cached here so they
           * can be reapplied at the proper time */
@@ -525,6 +591,31 @@ namespace graphene { namespace chain {
          /// Enable or disable tracking of votes of standby witnesses and committee members
          inline void enable_standby_votes_tracking(bool enable)  { _track_standby_votes = enable; }
 
+         /// Enable or disable timing of operations, evaluator phases and block stages, see @ref chain_profiler.
+         /// Enabling an already enabled profiler keeps the accumulated counters.
+         void enable_profiling( bool enable );
+         /// @return the profiler, or nullptr if profiling is disabled
+         chain_profiler* get_profiler()const { return _profiler.get(); }
+
+         /// Wall time and objects touched per phase of the last chain maintenance
+         const maintenance_report& get_last_maintenance_report()const { return _last_maintenance_report; }
+
+         /**
+          * Perform chain maintenance on the current head state in an undo session which is discarded
+          * afterwards, to find out how long the next maintenance will take.  Pending transactions are
+          * popped for the run and pushed again afterwards.
+          *
+          * Maintenance runs as if the next block were the maintenance block, i.e. at the next maintenance
+          * time, or one block interval after the head block if that is already past.
+          */
+         maintenance_report dry_run_maintenance();
+
+         /// Bound the pending transaction pool.  Limits apply to transactions pushed afterwards.
+         void set_pending_transactions_limits( const pending_transactions_limits& limits )
+         { _pending_tx_limits = limits; }
+         const pending_transactions_limits& get_pending_transactions_limits()const { return _pending_tx_limits; }
+         const pending_transactions_stats& get_pending_transactions_stats()const { return _pending_tx_stats; }
+
          /** Precomputes digests, signatures and operation validations depending
           *  on skip flags. "Expensive" computations may be done in a parallel
           *  thread.
@@ -544,9 +635,20 @@ namespace graphene { namespace chain {
           *         precomputations applied
           */
          fc::future<void> precompute_parallel( const precomputable_transaction& trx )const;
+
+         /**
+          * Let the transactions in @p block take over the signature keys which were recovered when they
+          * were pushed as pending transactions.  Called by precompute_parallel().
+          * @return the number of transactions which took over their keys
+          */
+         uint32_t reuse_recovered_signature_keys( const signed_block& block )const;
    private:
          template<typename Trx>
          void _precompute_parallel( const Trx* trx, const size_t count, const uint32_t skip )const;
+         /// Remember the signature keys of a pending transaction, for when it shows up in a block
+         void _remember_signature_keys( const precomputable_transaction& trx );
+         /// Forget the signature keys of the transactions in @p applied_block and of expired transactions
+         void _forget_signature_keys( const signed_block& applied_block );
 
    protected:
          //Mark pop_undo() as protected -- we do not want outside calling pop_undo(); it should call pop_block() instead
@@ -572,7 +674,14 @@ namespace graphene { namespace chain {
 
       private:
          void                  _apply_block( const signed_block& next_block );
-         processed_transaction _apply_transaction( const signed_transaction& trx );
+         processed_transaction _apply_transaction( const signed_transaction& trx, bool prechecked = false );
+         /// Read-only checks of a transaction against the chain state, see @ref precheck_transaction
+         void                  _check_transaction_dupe( const signed_transaction& trx, uint32_t skip )const;
+         void                  _check_transaction_tapos_and_expiration( const signed_transaction& trx,
+                                                                        uint32_t skip )const;
+         /// Rejects a new transaction if it does not fit the pending transaction pool
+         void                  _check_pending_transactions_limits( const precomputable_transaction& trx,
+                                                                   uint64_t trx_size );
          void                  _cancel_bids_and_revive_mpa( const asset_object& bitasset, const asset_bitasset_data_object& bad );
 
          ///Steps involved in applying a new block
@@ -628,6 +737,17 @@ namespace graphene { namespace chain {
          ///@}
 
          vector< processed_transaction >        _pending_tx;
+         pending_transactions_limits            _pending_tx_limits;
+         /// count and size follow _pending_tx, maintained by _push_transaction() and clear_pending()
+         pending_transactions_stats             _pending_tx_stats;
+         /// pending transactions per fee payer, only ever emptied as a whole by clear_pending()
+         std::map< account_id_type, uint32_t >  _pending_tx_per_account;
+         /**
+          * Signature keys recovered for pending transactions. Blocks may be precomputed on other threads
+          * than the one changing _pending_tx, so this is kept apart and guarded by a mutex.
+          */
+         recovered_signature_keys_index         _recovered_signature_keys;
+         mutable std::mutex                     _recovered_signature_keys_mutex;
          fork_database                          _fork_db;
 
          /**
@@ -670,6 +790,33 @@ namespace graphene { namespace chain {
          /// Set it to true to provide accurate data to API clients, set to false to have better performance.
          bool                              _track_standby_votes = true;
 
+         /// Only set while profiling is enabled
+         std::unique_ptr<chain_profiler>   _profiler;
+
+         maintenance_report                _last_maintenance_report;
+
+         /// Number of signal subscribers which need impacted accounts, see subscribe_to_impacted_accounts()
+         std::atomic<uint32_t>             _impacted_accounts_subscribers{0};
+         /// Number of observers of each objects signal connected with observe_without_impacted_accounts()
+         ///@{
+         std::shared_ptr< std::atomic<uint32_t> > _new_objects_without_accounts
+               = std::make_shared< std::atomic<uint32_t> >( 0 );
+         std::shared_ptr< std::atomic<uint32_t> > _changed_objects_without_accounts
+               = std::make_shared< std::atomic<uint32_t> >( 0 );
+         std::shared_ptr< std::atomic<uint32_t> > _removed_objects_without_accounts
+               = std::make_shared< std::atomic<uint32_t> >( 0 );
+         ///@}
+         const std::shared_ptr< std::atomic<uint32_t> >& _observers_without_impacted_accounts(
+               const decltype(new_objects)& signal )const
+         {
+            return &signal == &new_objects ? _new_objects_without_accounts : _changed_objects_without_accounts;
+         }
+         const std::shared_ptr< std::atomic<uint32_t> >& _observers_without_impacted_accounts(
+               const decltype(removed_objects)& )const
+         {
+            return _removed_objects_without_accounts;
+         }
+
          /**
           * Whether database is successfully opened or not.
           *
@@ -692,6 +839,15 @@ namespace graphene { namespace chain {
          const witness_schedule_object*         _p_witness_schedule_obj    = nullptr;
          ///@}
 
+         /// The shuffle of the current round, recomputed when its start time or witnesses differ from these
+         ///@{
+         const vector< witness_id_type >&       _get_shuffled_witnesses()const; ///< requires the mutex below
+         mutable time_point_sec                 _shuffled_round_start_time;
+         mutable vector< witness_id_type >      _shuffled_round_witnesses;
+         mutable vector< witness_id_type >      _shuffled_witnesses;
+         mutable std::mutex                     _shuffled_witnesses_mutex;
+         ///@}
+
          /// Maintenance pseudo random number generator
          ///@{
          class maintenance_prng
@@ -23,6 +23,7 @@
  * THE SOFTWARE.
  */
 #pragma once
+#include <graphene/chain/chain_profiler.hpp>
 #include <graphene/chain/exceptions.hpp>
 #include <graphene/chain/transaction_evaluation_state.hpp>
 #include <graphene/protocol/operations.hpp>
@@ -119,6 +120,7 @@ namespace graphene { namespace chain {
       const asset_object*              fee_asset          = nullptr;
       const asset_dynamic_data_object* fee_asset_dyn_data = nullptr;
       transaction_evaluation_state*    trx_state;
+      chain_profiler*                  _profiler = nullptr; ///< set while the database has profiling enabled
    };
 
    class op_evaluator
@@ -150,16 +152,20 @@ namespace graphene { namespace chain {
          auto* eval = static_cast<DerivedEvaluator*>(this);
          const auto& op = o.get<typename DerivedEvaluator::operation_type>();
 
-         prepare_fee(op.fee_payer(), op.fee);
-         if( !trx_state->skip_fee_schedule_check )
          {
-            share_type required_fee = calculate_fee_for_operation(op);
-            GRAPHENE_ASSERT( core_fee_paid >= required_fee,
-                       insufficient_fee,
-                       "Insufficient Fee Paid",
-                       ("core_fee_paid",core_fee_paid)("required", required_fee) );
+            chain_profiler::scoped_timer timer( _profiler, o.which(), chain_profiler::phase_fee );
+            prepare_fee(op.fee_payer(), op.fee);
+            if( !trx_state->skip_fee_schedule_check )
+            {
+               share_type required_fee = calculate_fee_for_operation(op);
+               GRAPHENE_ASSERT( core_fee_paid >= required_fee,
+                          insufficient_fee,
+                          "Insufficient Fee Paid",
+                          ("core_fee_paid",core_fee_paid)("required", required_fee) );
+            }
          }
 
+         chain_profiler::scoped_timer timer( _profiler, o.which(), chain_profiler::phase_evaluate );
          return eval->do_evaluate(op);
       }
 
@@ -168,11 +174,19 @@ namespace graphene { namespace chain {
          auto* eval = static_cast<DerivedEvaluator*>(this);
          const auto& op = o.get<typename DerivedEvaluator::operation_type>();
 
-         convert_fee();
-         pay_fee();
+         {
+            chain_profiler::scoped_timer timer( _profiler, o.which(), chain_profiler::phase_fee );
+            convert_fee();
+            pay_fee();
+         }
 
-         auto result = eval->do_apply(op);
+         operation_result result;
+         {
+            chain_profiler::scoped_timer timer( _profiler, o.which(), chain_profiler::phase_apply );
+            result = eval->do_apply(op);
+         }
 
+         chain_profiler::scoped_timer timer( _profiler, o.which(), chain_profiler::phase_fee );
          db_adjust_balance(op.fee_payer(), -fee_from_account);
 
          return result;
@@ -134,6 +134,16 @@ struct genesis_state_type {
    /// Method to override initial witness signing keys for debug
    void override_witness_signing_keys( const std::string& new_key );
 
+   /**
+    * Parse a genesis state from JSON.
+    *
+    * The result is the same as converting the output of fc::json::from_string(), but the large arrays
+    * (accounts and balances) are split off without building a variant tree for the whole document and
+    * their elements are converted in parallel. This keeps peak memory close to the size of the text plus
+    * the resulting genesis state for test networks with millions of initial accounts.
+    */
+   static genesis_state_type from_json( const std::string& json, uint32_t max_depth );
+
 };
 
 } } // namespace graphene::chain
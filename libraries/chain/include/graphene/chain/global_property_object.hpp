@@ -106,6 +106,12 @@ namespace graphene { namespace chain {
 
          uint32_t last_irreversible_block_num = 0;
 
+         /**
+          * Time of the block that started the current round of witness production, which seeds the shuffle of
+          * the round.  Not set in the first round after genesis, which is not shuffled.
+          */
+         time_point_sec witness_round_start_time;
+
          enum dynamic_flag_bits
          {
             /**
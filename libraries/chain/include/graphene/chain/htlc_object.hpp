@@ -28,8 +28,12 @@
 
 #include <boost/multi_index/composite_key.hpp>
 
+#include <map>
+#include <mutex>
+
 namespace graphene { namespace chain {
    using namespace protocol;
+   using namespace graphene::db;
 
    /**
     * @brief database object to store HTLCs
@@ -114,6 +118,26 @@ namespace graphene { namespace chain {
 
    typedef generic_index< htlc_object, htlc_object_index_type > htlc_index;
 
+   /**
+    * @brief This secondary index tracks the hash algorithm of every HTLC, so that transaction precomputation
+    * can hash the preimages of redeem operations on other threads, with just the algorithm that is needed.
+    *
+    * The hash lock of an HTLC never changes, so only insertion and removal are tracked.
+    */
+   class htlc_hash_algorithm_index : public secondary_index
+   {
+      public:
+         virtual void object_inserted( const object& obj ) override;
+         virtual void object_removed( const object& obj ) override;
+
+         /// @return the preimage hash of @p htlc, whose type is the algorithm, if the HTLC exists
+         fc::optional<htlc_hash> get_algorithm( const htlc_id_type& htlc )const;
+
+      private:
+         mutable std::mutex                  mutex;
+         std::map< htlc_id_type, htlc_hash > algorithms;
+   };
+
 } } // namespace graphene::chain
 
 MAP_OBJECT_ID_TO_TYPE(graphene::chain::htlc_object)
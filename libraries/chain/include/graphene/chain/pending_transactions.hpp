@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2023 R-Squared Labs LLC, and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <graphene/chain/types.hpp>
+#include <graphene/protocol/transaction.hpp>
+
+#include <fc/reflect/reflect.hpp>
+
+#include <boost/multi_index_container.hpp>
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/ordered_index.hpp>
+#include <boost/multi_index/hashed_index.hpp>
+
+#include <cstdint>
+
+namespace graphene { namespace chain {
+
+   /**
+    * Bounds of the pending transaction pool of a node.  A value of 0 means unlimited.
+    */
+   struct pending_transactions_limits
+   {
+      uint32_t max_count             = 0; ///< maximum number of pending transactions
+      uint64_t max_size              = 0; ///< maximum total packed size of pending transactions in bytes
+      uint32_t max_per_account       = 0; ///< maximum number of pending transactions per fee paying account
+      uint32_t max_assembly_time_ms  = 0; ///< time after which block production stops adding transactions
+   };
+
+   /**
+    * Current state and counters of the pending transaction pool
+    */
+   struct pending_transactions_stats
+   {
+      uint32_t count                  = 0; ///< number of pending transactions
+      uint64_t size                   = 0; ///< total packed size of pending transactions in bytes
+      uint64_t rejected_pool_full     = 0; ///< transactions rejected because of max_count or max_size
+      uint64_t rejected_account_limit = 0; ///< transactions rejected because of max_per_account
+      uint32_t last_block_included    = 0; ///< transactions added to the last produced block
+      uint32_t last_block_postponed   = 0; ///< transactions left pending when producing the last block
+      uint64_t last_block_assembly_us = 0; ///< time spent applying transactions for the last produced block
+   };
+
+   /**
+    * Public keys recovered from the signatures of a pending transaction, so that they need not be recovered
+    * again when the transaction shows up in a block
+    */
+   struct recovered_signature_keys
+   {
+      transaction_id_type          trx_id;
+      fc::time_point_sec           expiration;
+      vector<signature_type>       signatures;
+      flat_set<public_key_type>    keys;
+   };
+
+   struct by_trx_id;
+   struct by_expiration;
+   typedef boost::multi_index_container<
+      recovered_signature_keys,
+      boost::multi_index::indexed_by<
+         boost::multi_index::hashed_unique< boost::multi_index::tag<by_trx_id>,
+            BOOST_MULTI_INDEX_MEMBER(recovered_signature_keys, transaction_id_type, trx_id),
+            std::hash<transaction_id_type> >,
+         boost::multi_index::ordered_non_unique< boost::multi_index::tag<by_expiration>,
+            BOOST_MULTI_INDEX_MEMBER(recovered_signature_keys, fc::time_point_sec, expiration) >
+      >
+   > recovered_signature_keys_index;
+
+} } // graphene::chain
+
+FC_REFLECT( graphene::chain::pending_transactions_limits,
+            (max_count)(max_size)(max_per_account)(max_assembly_time_ms) )
+FC_REFLECT( graphene::chain::pending_transactions_stats,
+            (count)(size)(rejected_pool_full)(rejected_account_limit)
+            (last_block_included)(last_block_postponed)(last_block_assembly_us) )
@@ -194,9 +194,17 @@ namespace graphene { namespace chain {
     * @ingroup object_index
     */
    struct by_account;
+   struct by_account_asset_type;
    // by_vesting_type index MUST NOT be used for iterating because order is not well-defined.
    struct by_vesting_type;
 
+   // key extractor for the asset of a vesting balance
+   struct vesting_balance_asset_extractor
+   {
+      typedef asset_id_type result_type;
+      const result_type& operator()( const vesting_balance_object& vbo )const { return vbo.balance.asset_id; }
+   };
+
 namespace detail {
 
    /**
@@ -259,6 +267,14 @@ namespace detail {
          ordered_non_unique< tag<by_account>,
             member<vesting_balance_object, account_id_type, &vesting_balance_object::owner>
          >,
+         ordered_unique< tag<by_account_asset_type>,
+            composite_key< vesting_balance_object,
+               member<vesting_balance_object, account_id_type, &vesting_balance_object::owner>,
+               vesting_balance_asset_extractor,
+               member<vesting_balance_object, vesting_balance_type, &vesting_balance_object::balance_type>,
+               member<object, object_id_type, &object::id>
+            >
+         >,
          hashed_unique< tag<by_vesting_type>,
             identity<vesting_balance_object>,
             detail::vesting_balance_object_hash,
@@ -27,13 +27,19 @@
 
 namespace graphene { namespace chain {
 
+/**
+ * The witnesses of the current production round.  Their order for the round is not stored, it is a shuffle
+ * seeded by the time the round started, see @ref dynamic_global_property_object::witness_round_start_time and
+ * database::get_shuffled_witnesses().  So this object is only written when the active witnesses change.
+ */
 class witness_schedule_object : public graphene::db::abstract_object<witness_schedule_object>
 {
    public:
       static constexpr uint8_t space_id = implementation_ids;
       static constexpr uint8_t type_id = impl_witness_schedule_object_type;
 
-      vector< witness_id_type > current_shuffled_witnesses;
+      /// The active witnesses when the current round started, in ID order
+      vector< witness_id_type > current_witnesses;
 };
 
 } }
@@ -34,8 +34,6 @@ namespace graphene { namespace chain {
 
 bool proposal_object::is_authorized_to_execute( database& db ) const
 {
-   transaction_evaluation_state dry_run_eval( &db );
-
    try {
       bool allow_non_immediate_owner = true;
       verify_authority( proposed_transaction.operations,
@@ -59,10 +59,14 @@ namespace graphene { namespace db {
             ObjectType item;
             item.id = get_next_id();
             constructor( item );
-            auto insert_result = _indices.insert( std::move(item) );
-            FC_ASSERT(insert_result.second, "Could not create object! Most likely a uniqueness constraint is violated.");
+            // New objects always carry the highest ID so far, hinting at the end of the primary index
+            // turns the by_id insertion into an amortized constant time append
+            const auto old_size = _indices.size();
+            auto insert_result = _indices.insert( _indices.end(), std::move(item) );
+            FC_ASSERT( _indices.size() > old_size,
+                       "Could not create object! Most likely a uniqueness constraint is violated." );
             use_next_id();
-            return *insert_result.first;
+            return *insert_result;
          }
 
          virtual void modify( const object& obj, const std::function<void(object&)>& m )override
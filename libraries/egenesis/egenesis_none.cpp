@@ -45,4 +45,9 @@ fc::sha256 get_egenesis_json_hash()
    return fc::sha256::hash( "" );
 }
 
+bool compute_egenesis_state( genesis_state_type& result )
+{
+   return false;
+}
+
 } }
@@ -8,8 +8,15 @@ message( STATUS "Chain-id: ${chain_id}" )
 
 set( generated_file_banner "/*** GENERATED FILE - DO NOT EDIT! ***/" )
 set( genesis_json_hash "${chain_id}" )
-configure_file( "${CMAKE_CURRENT_SOURCE_DIR}/egenesis_brief.cpp.tmpl"
-                "${CMAKE_CURRENT_BINARY_DIR}/egenesis_brief.cpp" )
+# The chain ID is the hash of the genesis JSON, emit it as bytes so that it needs no parsing at runtime
+string( REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," chain_id_array "${chain_id}" )
+
+# The brief egenesis only needs the chain ID, the full one is generated when the packed binary is given
+if( NOT embed_genesis_binary )
+   configure_file( "${CMAKE_CURRENT_SOURCE_DIR}/egenesis_brief.cpp.tmpl"
+                   "${CMAKE_CURRENT_BINARY_DIR}/egenesis_brief.cpp" )
+   return()
+endif()
 
 file( READ "${embed_genesis_args}" genesis_json )
 string( LENGTH "${genesis_json}" genesis_json_length )
@@ -30,5 +37,16 @@ string( REGEX REPLACE ";" "\",\n\"" genesis_json_array "${_chunks}" )
 set( genesis_json_array "\"${genesis_json_array}\",\n\"${_rest}\"" )
 set( genesis_json_array_height "${_chunks_len} - ${_seen} + 2" )
 
+# Embed the packed binary genesis as a byte array, 16 bytes per line
+file( READ "${embed_genesis_binary}" genesis_binary_hex HEX )
+string( LENGTH "${genesis_binary_hex}" genesis_binary_length )
+math( EXPR genesis_binary_length "${genesis_binary_length} / 2" )
+string( REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," genesis_binary_array "${genesis_binary_hex}" )
+set( _line_regex "" )
+foreach( _i RANGE 1 16 )
+   set( _line_regex "${_line_regex}0x[0-9a-f][0-9a-f]," )
+endforeach()
+string( REGEX REPLACE "(${_line_regex})" "\\1\n" genesis_binary_array "${genesis_binary_array}" )
+
 configure_file( "${CMAKE_CURRENT_SOURCE_DIR}/egenesis_full.cpp.tmpl"
                 "${CMAKE_CURRENT_BINARY_DIR}/egenesis_full.cpp" )
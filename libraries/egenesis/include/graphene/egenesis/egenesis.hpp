@@ -48,4 +48,13 @@ void compute_egenesis_json( std::string& result );
  */
 fc::sha256 get_egenesis_json_hash();
 
+/**
+ * Unpack the egenesis from the binary form that was packed at build time. This
+ * needs neither JSON parsing nor hashing, the chain ID of the result is set from
+ * the value computed at build time.
+ *
+ * @return false if no binary egenesis was compiled in
+ */
+bool compute_egenesis_state( graphene::chain::genesis_state_type& result );
+
 } } // graphene::egenesis
@@ -23,6 +23,7 @@
  */
 
 #include <graphene/api_helper_indexes/api_helper_indexes.hpp>
+#include <graphene/chain/database.hpp>
 #include <graphene/chain/market_object.hpp>
 #include <graphene/chain/proposal_object.hpp>
 
@@ -92,6 +93,67 @@ share_type amount_in_collateral_index::get_backing_collateral( const asset_id_ty
    return itr->second;
 } FC_CAPTURE_AND_RETHROW( (asst) ) }
 
+void asset_holders_index::object_inserted( const object& objct )
+{
+   _dirty.push_back( objct.id );
+}
+
+void asset_holders_index::object_removed( const object& objct )
+{
+   _dirty.push_back( objct.id );
+}
+
+void asset_holders_index::about_to_modify( const object& objct )
+{
+}
+
+void asset_holders_index::object_modified( const object& objct )
+{
+   _dirty.push_back( objct.id );
+}
+
+void asset_holders_index::flush()const
+{ try {
+   if( _dirty.empty() )
+      return;
+
+   std::sort( _dirty.begin(), _dirty.end() );
+   _dirty.erase( std::unique( _dirty.begin(), _dirty.end() ), _dirty.end() );
+   if( _entries.size() <= _dirty.back().instance() )
+      _entries.resize( _dirty.back().instance() + 1 );
+
+   for( const object_id_type& id : _dirty )
+   {
+      holder_entry& entry = _entries[ id.instance() ];
+      if( entry.valid )
+      {
+         _holders[ entry.asset ].erase( entry.holder );
+         entry.valid = false;
+      }
+
+      // the object is gone if it was removed, or if its creation was undone
+      const auto* abo = static_cast< const account_balance_object* >( _db->find_object( id ) );
+      if( abo != nullptr )
+      {
+         entry.valid  = true;
+         entry.asset  = abo->asset_type;
+         entry.holder = balance_holder{ abo->balance, abo->owner };
+         _holders[ entry.asset ].insert( entry.holder );
+      }
+   }
+   _dirty.clear();
+} FC_CAPTURE_AND_RETHROW() }
+
+const balance_holder_set& asset_holders_index::get_holders( const asset_id_type& asst )const
+{ try {
+   static const balance_holder_set _empty;
+
+   flush();
+   auto itr = _holders.find( asst );
+   if( itr == _holders.end() ) return _empty;
+   return itr->second;
+} FC_CAPTURE_AND_RETHROW( (asst) ) }
+
 namespace detail
 {
 
@@ -157,6 +219,14 @@ void api_helper_indexes::plugin_startup()
    auto& approvals = *database().add_secondary_index< primary_index<proposal_index>, required_approval_index >();
    for( const auto& proposal : database().get_index_type< proposal_index >().indices() )
       approvals.object_inserted( proposal );
+
+   const graphene::chain::database* db = &database();
+   auto& holders = *database().add_secondary_index< primary_index<account_balance_index>, asset_holders_index >( db );
+   for( const auto& balance : database().get_index_type< account_balance_index >().indices() )
+      holders.object_inserted( balance );
+   holders.flush();
+   database().observe( database().applied_block, "api_helper_indexes",
+                       [&holders]( const signed_block& ) { holders.flush(); } );
 }
 
 } }
@@ -24,6 +24,7 @@
 #pragma once
 
 #include <graphene/app/plugin.hpp>
+#include <graphene/chain/account_object.hpp>
 #include <graphene/protocol/types.hpp>
 
 namespace graphene { namespace api_helper_indexes {
@@ -51,6 +52,43 @@ class amount_in_collateral_index : public secondary_index
       flat_map<asset_id_type, share_type> backing_collateral;
 };
 
+/**
+ *  @brief This secondary index keeps the holders of every asset sorted by balance, for the asset API.
+ *
+ *  Balance changes only record the ID of the balance object, so that the consensus code path does not pay
+ *  for the sorting. The recorded changes are folded into the sorted sets once per block, and before a query.
+ */
+class asset_holders_index : public secondary_index
+{
+   public:
+      explicit asset_holders_index( const graphene::chain::database* db ) : _db( db ) {}
+
+      void object_inserted( const object& obj ) override;
+      void object_removed( const object& obj ) override;
+      void about_to_modify( const object& before ) override;
+      void object_modified( const object& after ) override;
+
+      /// Fold the recorded balance changes into the sorted sets
+      void flush()const;
+
+      /// @return the holders of @p asset including zero balances, largest balance first
+      const balance_holder_set& get_holders( const asset_id_type& asset )const;
+
+   private:
+      /// The last flushed state of a balance object
+      struct holder_entry
+      {
+         bool           valid = false;
+         asset_id_type  asset;
+         balance_holder holder;
+      };
+
+      const graphene::chain::database*                _db;
+      mutable vector<object_id_type>                  _dirty;
+      mutable vector<holder_entry>                    _entries; ///< by balance object instance
+      mutable std::map<asset_id_type, balance_holder_set> _holders;
+};
+
 namespace detail
 {
     class api_helper_indexes_impl;
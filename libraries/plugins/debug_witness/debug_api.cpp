@@ -28,6 +28,10 @@ class debug_api_impl
       void debug_update_object( const fc::variant_object& update );
       void debug_stream_json_objects( const std::string& filename );
       void debug_stream_json_objects_flush();
+      void debug_enable_profiling( bool enable );
+      graphene::chain::chain_profile_report debug_get_profile();
+      void debug_reset_profile();
+      graphene::chain::maintenance_report debug_dry_run_maintenance();
       std::shared_ptr< graphene::debug_witness_plugin::debug_witness_plugin > get_plugin();
 
       graphene::app::application& app;
@@ -121,6 +125,30 @@ void debug_api_impl::debug_stream_json_objects_flush()
    get_plugin()->flush_json_object_stream();
 }
 
+void debug_api_impl::debug_enable_profiling( bool enable )
+{
+   app.chain_database()->enable_profiling( enable );
+}
+
+graphene::chain::chain_profile_report debug_api_impl::debug_get_profile()
+{
+   const graphene::chain::chain_profiler* profiler = app.chain_database()->get_profiler();
+   FC_ASSERT( profiler != nullptr, "Profiling is not enabled" );
+   return profiler->get_report();
+}
+
+void debug_api_impl::debug_reset_profile()
+{
+   graphene::chain::chain_profiler* profiler = app.chain_database()->get_profiler();
+   FC_ASSERT( profiler != nullptr, "Profiling is not enabled" );
+   profiler->reset();
+}
+
+graphene::chain::maintenance_report debug_api_impl::debug_dry_run_maintenance()
+{
+   return app.chain_database()->dry_run_maintenance();
+}
+
 } // detail
 
 debug_api::debug_api( graphene::app::application& app )
@@ -153,5 +181,25 @@ void debug_api::debug_stream_json_objects_flush()
    my->debug_stream_json_objects_flush();
 }
 
+void debug_api::debug_enable_profiling( bool enable )
+{
+   my->debug_enable_profiling( enable );
+}
+
+graphene::chain::chain_profile_report debug_api::debug_get_profile()
+{
+   return my->debug_get_profile();
+}
+
+void debug_api::debug_reset_profile()
+{
+   my->debug_reset_profile();
+}
+
+graphene::chain::maintenance_report debug_api::debug_dry_run_maintenance()
+{
+   return my->debug_dry_run_maintenance();
+}
+
 
 } } // graphene::debug_witness
@@ -26,6 +26,8 @@
 #include <memory>
 #include <string>
 
+#include <graphene/chain/chain_profiler.hpp>
+
 #include <fc/api.hpp>
 #include <fc/variant_object.hpp>
 
@@ -82,6 +84,28 @@ class debug_api
        */
       void debug_stream_json_objects_flush();
 
+      /**
+       * Enable or disable the chain profiler. Disabling it discards the accumulated counters.
+       */
+      void debug_enable_profiling( bool enable );
+
+      /**
+       * Get the time spent per operation type, evaluator phase and block stage since profiling was enabled
+       * or last reset.
+       */
+      graphene::chain::chain_profile_report debug_get_profile();
+
+      /**
+       * Reset the chain profiler counters.
+       */
+      void debug_reset_profile();
+
+      /**
+       * Perform chain maintenance on the current head state and discard the result.
+       * @return wall time and number of objects touched per maintenance phase
+       */
+      graphene::chain::maintenance_report debug_dry_run_maintenance();
+
       std::shared_ptr< detail::debug_api_impl > my;
 };
 
@@ -93,4 +117,8 @@ FC_API(graphene::debug_witness::debug_api,
        (debug_update_object)
        (debug_stream_json_objects)
        (debug_stream_json_objects_flush)
+       (debug_enable_profiling)
+       (debug_get_profile)
+       (debug_reset_profile)
+       (debug_dry_run_maintenance)
      )
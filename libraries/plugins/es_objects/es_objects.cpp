@@ -362,13 +362,13 @@ void es_objects_plugin::plugin_initialize(const boost::program_options::variable
       my->_es_objects_start_es_after_block = options["es-objects-start-es-after-block"].as<uint32_t>();
    }
 
-   database().applied_block.connect([this](const signed_block &b) {
+   database().observe(database().applied_block, "es_objects", [this](const signed_block &b) {
       if(b.block_num() == 1 && my->_es_objects_start_es_after_block == 0) {
          if (!my->genesis())
             FC_THROW_EXCEPTION(graphene::chain::plugin_exception, "Error populating genesis data.");
       }
    });
-   database().new_objects.connect([this]( const vector<object_id_type>& ids,
+   database().observe(database().new_objects, "es_objects", [this]( const vector<object_id_type>& ids,
          const flat_set<account_id_type>& impacted_accounts ) {
       if(!my->index_database(ids, "create"))
       {
@@ -376,7 +376,7 @@ void es_objects_plugin::plugin_initialize(const boost::program_options::variable
                "Error creating object from ES database, we are going to keep trying.");
       }
    });
-   database().changed_objects.connect([this]( const vector<object_id_type>& ids,
+   database().observe(database().changed_objects, "es_objects", [this]( const vector<object_id_type>& ids,
          const flat_set<account_id_type>& impacted_accounts ) {
       if(!my->index_database(ids, "update"))
       {
@@ -384,7 +384,7 @@ void es_objects_plugin::plugin_initialize(const boost::program_options::variable
                "Error updating object from ES database, we are going to keep trying.");
       }
    });
-   database().removed_objects.connect([this](const vector<object_id_type>& ids,
+   database().observe(database().removed_objects, "es_objects", [this](const vector<object_id_type>& ids,
          const vector<const object*>& objs, const flat_set<account_id_type>& impacted_accounts) {
       if(!my->index_database(ids, "delete"))
       {
@@ -204,7 +204,7 @@ void witness_plugin::plugin_startup()
          _production_skip_flags |= graphene::chain::database::skip_undo_history_check;
       }
       refresh_witness_key_cache();
-      d.applied_block.connect( [this]( const chain::signed_block& b )
+      d.observe( d.applied_block, "witness", [this]( const chain::signed_block& b )
       {
          refresh_witness_key_cache();
       });
@@ -220,7 +220,7 @@ void witness_plugin::plugin_startup()
 
    _network_broadcast_api = std::make_shared< app::network_broadcast_api >( std::ref( app() ) );
 
-   database().applied_block.connect([this](const signed_block &b) {
+   database().observe(database().applied_block, "witness_commit_reveal", [this](const signed_block &b) {
       commit_reveal_operations();
    });
 
@@ -29,6 +29,39 @@
 
 namespace graphene { namespace protocol {
 
+   namespace {
+
+      struct preimage_hash_visitor
+      {
+         typedef htlc_hash result_type;
+
+         const std::vector<char>& preimage;
+
+         template<typename T>
+         htlc_hash operator()( const T& )const
+         {
+            return T::hash( (const char*)preimage.data(), (uint32_t) preimage.size() );
+         }
+      };
+
+      struct preimage_match_visitor
+      {
+         typedef bool result_type;
+
+         const std::vector<char>& preimage;
+         const htlc_hash*         precomputed;
+
+         template<typename T>
+         bool operator()( const T& preimage_hash )const
+         {
+            if( precomputed != nullptr )
+               return precomputed->get<T>() == preimage_hash;
+            return T::hash( (const char*)preimage.data(), (uint32_t) preimage.size() ) == preimage_hash;
+         }
+      };
+
+   } // anonymous namespace
+
    void htlc_create_operation::validate()const {
       FC_ASSERT( fee.amount >= 0, "Fee amount should not be negative" );
       FC_ASSERT( amount.amount > 0, "HTLC amount should be greater than zero" );
@@ -58,6 +91,27 @@ namespace graphene { namespace protocol {
       return fee_params.fee + product;
    }
 
+   void htlc_redeem_operation::precompute_preimage_hash( const htlc_hash& algorithm )const
+   {
+      if( precomputed_hash && precomputed_hash->hash.which() == algorithm.which()
+            && precomputed_hash->preimage == preimage )
+         return;
+      auto result = std::make_shared<precomputed_preimage_hash>();
+      result->preimage = preimage;
+      result->hash = algorithm.visit( preimage_hash_visitor{ preimage } );
+      precomputed_hash = std::move( result );
+   }
+
+   bool htlc_redeem_operation::preimage_matches( const htlc_hash& preimage_hash )const
+   {
+      const htlc_hash* precomputed = nullptr;
+      // the cached hash follows copies of the operation, only use it if the preimage is still the same
+      if( precomputed_hash && precomputed_hash->hash.which() == preimage_hash.which()
+            && precomputed_hash->preimage == preimage )
+         precomputed = &precomputed_hash->hash;
+      return preimage_hash.visit( preimage_match_visitor{ preimage, precomputed } );
+   }
+
    void htlc_extend_operation::validate()const {
       FC_ASSERT( fee.amount >= 0 , "Fee amount should not be negative");
    }
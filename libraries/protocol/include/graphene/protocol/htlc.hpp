@@ -28,6 +28,7 @@
 #include <graphene/protocol/asset.hpp>
 #include <graphene/protocol/memo.hpp>
 #include <algorithm> // std::max
+#include <memory>
 
 namespace graphene { namespace protocol {
       typedef fc::ripemd160    htlc_algo_ripemd160;
@@ -119,6 +120,29 @@ namespace graphene { namespace protocol {
           * @brief calculates the fee to be paid for this operation
           */
          share_type calculate_fee(const fee_parameters_type& fee_params)const;
+
+         /// A hash of the preimage, together with the preimage it was computed from
+         struct precomputed_preimage_hash
+         {
+            std::vector<char> preimage;
+            htlc_hash         hash;
+         };
+
+         /****
+          * @brief hashes the preimage with the algorithm of @p algorithm and keeps the result, so that
+          * transaction precomputation can do the hashing outside of the evaluator
+          * @param algorithm a hash of the algorithm the HTLC was created with, only its type is used
+          */
+         void precompute_preimage_hash( const htlc_hash& algorithm )const;
+
+         /****
+          * @brief checks whether the preimage generates the given hash, using the precomputed hash if it was
+          * computed with the same algorithm from the same preimage
+          */
+         bool preimage_matches( const htlc_hash& preimage_hash )const;
+
+         /// set by precompute_preimage_hash(), not serialized
+         mutable std::shared_ptr<const precomputed_preimage_hash> precomputed_hash;
       };
 
       /**
@@ -242,6 +242,17 @@ namespace graphene { namespace protocol {
       virtual void                             validate()const override;
       virtual const flat_set<public_key_type>& get_signature_keys( const chain_id_type& chain_id )const override;
       virtual uint64_t                         get_packed_size()const override;
+
+      /// Whether the public keys have been extracted from the signatures already
+      bool has_signature_keys()const { return !_signees.empty(); }
+
+      /**
+       * Take over public keys already extracted from @p sigs for a transaction with the same id, e.g. a
+       * pending transaction which is now included in a block.  The keys are only taken over if the
+       * signatures are the same and no keys have been extracted yet.
+       * @return whether the keys were taken over
+       */
+      bool reuse_signature_keys( const vector<signature_type>& sigs, const flat_set<public_key_type>& keys )const;
    protected:
       mutable bool _validated = false;
       mutable uint64_t _packed_size = 0;
@@ -298,7 +309,11 @@ namespace graphene { namespace protocol {
 
       vector<operation_result> operation_results;
 
+      /// The leaf of the block's merkle tree, cached: the transaction must not change after the first call
       digest_type merkle_digest()const;
+   private:
+      mutable digest_type _merkle_digest;
+      mutable bool        _merkle_digest_valid = false;
    };
 
    /// @} transactions group
@@ -36,9 +36,14 @@ namespace graphene { namespace protocol {
 
 digest_type processed_transaction::merkle_digest()const
 {
-   digest_type::encoder enc;
-   fc::raw::pack( enc, *this );
-   return enc.result();
+   if( !_merkle_digest_valid )
+   {
+      digest_type::encoder enc;
+      fc::raw::pack( enc, *this );
+      _merkle_digest = enc.result();
+      _merkle_digest_valid = true;
+   }
+   return _merkle_digest;
 }
 
 digest_type transaction::digest()const
@@ -462,6 +467,15 @@ const flat_set<public_key_type>& precomputable_transaction::get_signature_keys(
    return _signees;
 }
 
+bool precomputable_transaction::reuse_signature_keys( const vector<signature_type>& sigs,
+                                                      const flat_set<public_key_type>& keys )const
+{
+   if( !_signees.empty() || keys.empty() || signatures != sigs )
+      return false;
+   _signees = keys;
+   return true;
+}
+
 void signed_transaction::verify_authority( const chain_id_type& chain_id,
                                            const std::function<const authority*(account_id_type)>& get_active,
                                            const std::function<const authority*(account_id_type)>& get_owner,
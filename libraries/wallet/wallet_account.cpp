@@ -302,7 +302,7 @@ namespace graphene { namespace wallet { namespace detail {
          return result;
       }
 
-      vector< vesting_balance_object > vbos = _remote_db->get_vesting_balances( account_name );
+      vector< vesting_balance_object > vbos = _remote_db->get_vesting_balances( account_name, {}, {} );
       if( vbos.size() == 0 )
          return result;
 
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2023 R-Squared Labs LLC, and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/**
+ * Converts a genesis state between its JSON form and the packed binary form (fc::raw serialization of
+ * genesis_state_type) that is embedded into egenesis at build time.
+ *
+ * The chain ID of a JSON genesis is the SHA256 of the file contents. The binary form does not carry it,
+ * so it is printed when converting from JSON to allow recording it next to the binary.
+ */
+
+#include <fstream>
+#include <iostream>
+
+#include <fc/io/fstream.hpp>
+#include <fc/io/json.hpp>
+#include <fc/io/raw.hpp>
+
+#include <graphene/chain/genesis_state.hpp>
+
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+
+using namespace graphene::chain;
+namespace bpo = boost::program_options;
+
+int main( int argc, char** argv )
+{
+   try
+   {
+      bpo::options_description cli_options("R-Squared genesis converter");
+      cli_options.add_options()
+            ("help,h", "Print this help message and exit.")
+            ("json-to-binary", "Convert a JSON genesis to the binary form (default)")
+            ("binary-to-json", "Convert a binary genesis to JSON")
+            ("in,i", bpo::value<boost::filesystem::path>(), "File to read the genesis from")
+            ("out,o", bpo::value<boost::filesystem::path>(), "File to write the converted genesis to")
+            ;
+
+      bpo::variables_map options;
+      try
+      {
+         bpo::store( bpo::parse_command_line(argc, argv, cli_options), options );
+      }
+      catch (const bpo::error& e)
+      {
+         std::cerr << "convert_genesis:  error parsing command line: " << e.what() << "\n";
+         return 1;
+      }
+
+      if( options.count("help") )
+      {
+         std::cout << cli_options << "\n";
+         return 0;
+      }
+
+      if( !options.count("in") || !options.count("out") )
+      {
+         std::cerr << "convert_genesis:  --in and --out options are required\n";
+         return 1;
+      }
+      if( options.count("json-to-binary") && options.count("binary-to-json") )
+      {
+         std::cerr << "convert_genesis:  --json-to-binary and --binary-to-json are mutually exclusive\n";
+         return 1;
+      }
+
+      const fc::path in_file = options["in"].as<boost::filesystem::path>();
+      const fc::path out_file = options["out"].as<boost::filesystem::path>();
+      std::string input;
+      fc::read_file_contents( in_file, input );
+
+      if( options.count("binary-to-json") )
+      {
+         const auto genesis = fc::raw::unpack<genesis_state_type>( std::vector<char>( input.begin(), input.end() ) );
+         fc::json::save_to_file( genesis, out_file );
+         std::cerr << "convert_genesis:  Wrote JSON genesis to " << out_file.preferred_string() << "\n";
+      }
+      else
+      {
+         const auto genesis = genesis_state_type::from_json( input, 20 );
+         const std::vector<char> packed = fc::raw::pack( genesis );
+         std::ofstream out( out_file.generic_string(),
+                            std::ofstream::binary | std::ofstream::out | std::ofstream::trunc );
+         FC_ASSERT( out, "Unable to open ${f}", ("f",out_file) );
+         out.write( packed.data(), packed.size() );
+         out.close();
+         std::cerr << "convert_genesis:  Wrote " << packed.size() << " bytes of binary genesis to "
+                   << out_file.preferred_string() << ", chain ID "
+                   << fc::sha256::hash( input ).str() << "\n";
+      }
+   }
+   catch ( const fc::exception& e )
+   {
+      std::cerr << e.to_detail_string() << "\n";
+      return 1;
+   }
+   return 0;
+}
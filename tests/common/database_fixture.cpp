@@ -367,6 +367,8 @@ std::shared_ptr<boost::program_options::variables_map> database_fixture_base::in
    if( fixture.current_test_name == "asset_in_collateral"
             || fixture.current_test_name == "htlc_database_api"
             || fixture.current_suite_name == "database_api_tests"
+            || ( fixture.current_suite_name == "asset_api_tests"
+                 && fixture.current_test_name != "asset_holders_require_plugin" )
             || fixture.current_suite_name == "api_limit_tests"
             || fixture.current_suite_name == "electoral_threshold_tests" )
    {
@@ -745,7 +747,7 @@ const asset_object& database_fixture_base::get_asset( const string& symbol )cons
 
 const account_object& database_fixture_base::get_account( const string& name )const
 {
-   const auto& idx = db.get_index_type<account_index>().indices().get<by_name>();
+   const auto& idx = db.get_index_type<account_index>().indices().get<by_name_hash>();
    const auto itr = idx.find(name);
    assert( itr != idx.end() );
    return *itr;
@@ -27,6 +27,8 @@
 #include <graphene/utilities/tempdir.hpp>
 
 #include <fc/crypto/digest.hpp>
+#include <fc/io/json.hpp>
+#include <fc/io/raw.hpp>
 
 #include <database_fixture.hpp>
 
@@ -47,39 +49,92 @@ BOOST_AUTO_TEST_CASE( operation_sanity_check )
    }
 }
 
+namespace {
+
+/// A genesis with the usual init witnesses plus @p account_count accounts, each with a balance and an ICO balance
+genesis_state_type make_bench_genesis( const public_key_type& witness_pub_key, int account_count )
+{
+   genesis_state_type genesis_state;
+   genesis_state.initial_timestamp = fc::time_point_sec( GRAPHENE_TESTING_GENESIS_TIMESTAMP );
+   genesis_state.initial_parameters.get_mutable_fees().zero_all_fees();
+   genesis_state.initial_active_witnesses = 10;
+   genesis_state.initial_chain_id = fc::sha256::hash(string("dummy_id"));
+   for( unsigned int i = 0; i < genesis_state.initial_active_witnesses; ++i )
+   {
+      auto name = "init"+fc::to_string(i);
+      genesis_state.initial_accounts.emplace_back(name, witness_pub_key, witness_pub_key, true);
+      genesis_state.initial_committee_candidates.push_back({name});
+      genesis_state.initial_witness_candidates.push_back({name, witness_pub_key});
+   }
+
+   const auto account_pub_key = fc::ecc::private_key::regenerate(fc::digest(account_count)).get_public_key();
+   genesis_state.initial_accounts.reserve( genesis_state.initial_accounts.size() + account_count );
+   genesis_state.initial_balances.reserve( account_count );
+   genesis_state.ico_balances.reserve( account_count );
+   for( int i = 0; i < account_count; ++i )
+   {
+      genesis_state.initial_accounts.emplace_back("target"+fc::to_string(i), public_key_type(account_pub_key));
+      genesis_state.initial_balances.push_back( { address(account_pub_key), GRAPHENE_SYMBOL, 1 } );
+      genesis_state.ico_balances.push_back( { "eth" + fc::to_string(i), 1 } );
+   }
+   return genesis_state;
+}
+
+} // anonymous namespace
+
+/**
+ * Measures how genesis loading scales with the size of the initial state: JSON parsing with the plain
+ * variant based parser and with genesis_state_type::from_json, and database initialization from the
+ * parsed state. The largest state is then used for the persistence and replay measurements.
+ */
 BOOST_AUTO_TEST_CASE( genesis_and_persistence_bench )
 {
    try {
       const auto witness_priv_key = fc::ecc::private_key::regenerate(fc::sha256::hash(string("null_key")) );
       const auto witness_pub_key = witness_priv_key.get_public_key();
 
-      genesis_state_type genesis_state;
-      genesis_state.initial_timestamp = fc::time_point_sec( GRAPHENE_TESTING_GENESIS_TIMESTAMP );
-      genesis_state.initial_parameters.get_mutable_fees().zero_all_fees();
-      genesis_state.initial_active_witnesses = 10;
-      genesis_state.initial_chain_id = fc::sha256::hash(string("dummy_id"));
-      for( unsigned int i = 0; i < genesis_state.initial_active_witnesses; ++i )
-      {
-         auto name = "init"+fc::to_string(i);
-         genesis_state.initial_accounts.emplace_back(name, witness_pub_key, witness_pub_key, true);
-         genesis_state.initial_committee_candidates.push_back({name});
-         genesis_state.initial_witness_candidates.push_back({name, witness_pub_key});
-      }
-
 #ifdef NDEBUG
       ilog("Running in release mode.");
-      const int account_count = 2000000;
+      const std::vector<int> account_counts = { 100000, 500000, 2000000 };
       const int blocks_to_produce = 1000000;
 #else
       ilog("Running in debug mode.");
-      const int account_count = 30000;
+      const std::vector<int> account_counts = { 3000, 10000, 30000 };
       const int blocks_to_produce = 1000;
 #endif
 
-      const auto account_pub_key = fc::ecc::private_key::regenerate(fc::digest(account_count)).get_public_key();
-      for( int i = 0; i < account_count; ++i )
-         genesis_state.initial_accounts.emplace_back("target"+fc::to_string(i),
-                                                     public_key_type(account_pub_key));
+      for( int count : account_counts )
+      {
+         const genesis_state_type generated = make_bench_genesis( witness_pub_key, count );
+         const std::string json = fc::json::to_string( generated );
+
+         fc::time_point start_time = fc::time_point::now();
+         const auto plain = fc::json::from_string( json ).as<genesis_state_type>( 20 );
+         const auto plain_time = fc::time_point::now() - start_time;
+
+         start_time = fc::time_point::now();
+         const auto parsed = genesis_state_type::from_json( json, 20 );
+         const auto parsed_time = fc::time_point::now() - start_time;
+         BOOST_CHECK( fc::raw::pack( plain ) == fc::raw::pack( parsed ) );
+
+         fc::temp_directory data_dir( graphene::utilities::temp_directory_path() );
+         database db;
+         start_time = fc::time_point::now();
+         db.open(data_dir.path(), [&parsed]{return parsed;}, "test");
+         const auto init_time = fc::time_point::now() - start_time;
+         const auto& accounts_by_name = db.get_index_type<account_index>().indices().get<by_name>();
+         BOOST_CHECK( accounts_by_name.find( "target" + fc::to_string(count - 1) ) != accounts_by_name.end() );
+
+         ilog( "${n} accounts, ${b} bytes of JSON: fc::json parse ${p} ms, from_json ${f} ms, "
+               "init_genesis ${i} ms (${r} accounts/s)",
+               ("n",count)("b",json.size())("p",plain_time.count()/1000)("f",parsed_time.count()/1000)
+               ("i",init_time.count()/1000)
+               ("r",init_time.count() > 0 ? uint64_t(count) * 1000000 / init_time.count() : 0) );
+         db.close();
+      }
+
+      const int account_count = account_counts.back();
+      const genesis_state_type genesis_state = make_bench_genesis( witness_pub_key, account_count );
 
       fc::temp_directory data_dir( graphene::utilities::temp_directory_path() );
 
@@ -30,11 +30,16 @@
 
 #include <graphene/chain/account_object.hpp>
 #include <graphene/chain/asset_object.hpp>
+#include <graphene/chain/global_property_object.hpp>
+#include <graphene/chain/htlc_object.hpp>
 #include <graphene/chain/proposal_object.hpp>
 
 #include <graphene/db/simple_index.hpp>
 
+#include <graphene/utilities/tempdir.hpp>
+
 #include <fc/crypto/digest.hpp>
+#include <fc/asio.hpp>
 
 #include "../common/database_fixture.hpp"
 #include <cstdlib>
@@ -210,4 +215,244 @@ BOOST_AUTO_TEST_CASE( one_hundred_k_benchmark )
    db._undo_db.enable();
 } FC_LOG_AND_RETHROW() }
 
+BOOST_AUTO_TEST_CASE( htlc_benchmark )
+{ try {
+   ACTORS( (alice)(bob) );
+   transfer( committee_account, alice_id, asset( 1000000 * GRAPHENE_BLOCKCHAIN_PRECISION ) );
+   transfer( committee_account, bob_id, asset( 1000000 * GRAPHENE_BLOCKCHAIN_PRECISION ) );
+   generate_block();
+   set_htlc_committee_parameters();
+   generate_block();
+
+   const uint32_t count = 1000;
+   const uint16_t preimage_size = 1024; // a redeem must fit into maximum_transaction_size
+   std::vector< std::vector<char> > preimages( count, std::vector<char>( preimage_size ) );
+   for( uint32_t i = 0; i < count; ++i )
+      for( uint16_t j = 0; j < preimage_size; ++j )
+         preimages[i][j] = char( ( i * 7919 + j * 31 ) & 0xff );
+
+   auto push_all = [this]( std::vector<precomputable_transaction>& trxs ) {
+      std::vector< fc::future<void> > precomputed;
+      precomputed.reserve( trxs.size() );
+      for( const auto& ptrx : trxs )
+         precomputed.push_back( db.precompute_parallel( ptrx ) );
+      for( size_t i = 0; i < trxs.size(); ++i )
+      {
+         precomputed[i].wait();
+         db.push_transaction( trxs[i] );
+      }
+      generate_block();
+   };
+
+   std::vector<precomputable_transaction> creates;
+   creates.reserve( count );
+   for( uint32_t i = 0; i < count; ++i )
+   {
+      htlc_create_operation op;
+      op.from = alice_id;
+      op.to = bob_id;
+      op.amount = asset( 1 + i );
+      op.claim_period_seconds = 86400;
+      op.preimage_hash = fc::sha256::hash( preimages[i].data(), preimages[i].size() );
+      op.preimage_size = preimage_size;
+      op.fee = db.current_fee_schedule().calculate_fee( op );
+      signed_transaction trx;
+      trx.operations.push_back( op );
+      set_expiration( db, trx );
+      sign( trx, alice_private_key );
+      creates.emplace_back( trx );
+   }
+   auto start = fc::time_point::now();
+   push_all( creates );
+   auto elapsed = fc::time_point::now() - start;
+   wlog( "Benchmark: ${n} HTLCs created/s", ("n",(uint64_t(count)*1000000)/std::max<int64_t>(elapsed.count(),1)) );
+
+   const auto& htlc_idx = db.get_index_type< htlc_index >().indices().get< by_from_id >();
+   std::vector<precomputable_transaction> redeems;
+   redeems.reserve( count );
+   const auto alice_htlcs = htlc_idx.equal_range( alice_id );
+   for( auto itr = alice_htlcs.first; itr != alice_htlcs.second; ++itr )
+   {
+      htlc_redeem_operation op;
+      op.htlc_id = itr->id;
+      op.redeemer = bob_id;
+      op.preimage = preimages[ itr->transfer.amount.value - 1 ];
+      op.fee = db.current_fee_schedule().calculate_fee( op );
+      signed_transaction trx;
+      trx.operations.push_back( op );
+      set_expiration( db, trx );
+      sign( trx, bob_private_key );
+      redeems.emplace_back( trx );
+   }
+   BOOST_REQUIRE_EQUAL( redeems.size(), count );
+   start = fc::time_point::now();
+   push_all( redeems );
+   elapsed = fc::time_point::now() - start;
+   wlog( "Benchmark: ${n} HTLCs redeemed/s with ${s} byte preimages",
+         ("n",(uint64_t(count)*1000000)/std::max<int64_t>(elapsed.count(),1))("s",preimage_size) );
+   BOOST_CHECK( htlc_idx.count( alice_id ) == 0 );
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_CASE( median_feed_benchmark )
+{
+   const time_point_sec now = fc::time_point::now();
+   const uint64_t cycles = 10000;
+
+   for( uint32_t producers : { 11u, 101u, 1001u } )
+   {
+      asset_bitasset_data_object o;
+      o.options.feed_lifetime_sec = 86400;
+      o.options.minimum_feeds = 1;
+      for( uint32_t i = 0; i < producers; ++i )
+      {
+         price_feed_with_icr feed;
+         feed.settlement_price = asset( 1000 + ( i * 7919 ) % producers, asset_id_type(1) ) / asset( 1000 );
+         feed.core_exchange_rate = asset( 1000 + ( i * 104729 ) % producers, asset_id_type(1) ) / asset( 1000 );
+         feed.maintenance_collateral_ratio = 1750 + i % 100;
+         feed.maximum_short_squeeze_ratio = 1100 + i % 50;
+         feed.initial_collateral_ratio = 1800 + i % 100;
+         o.feeds[account_id_type(i)] = std::make_pair( now - ( i % 3600 ), feed );
+      }
+
+      auto start = fc::time_point::now();
+      for( uint64_t i = 0; i < cycles; ++i )
+         o.update_median_feeds( now, now + 3600 );
+      auto elapsed = fc::time_point::now() - start;
+      wlog( "Benchmark: ${ups} median feed updates/s with ${n} feed producers",
+            ("ups",(cycles*1000000)/std::max<int64_t>(elapsed.count(),1))("n",producers) );
+   }
+}
+
+BOOST_AUTO_TEST_CASE( deep_fork_switch_benchmark )
+{ try {
+   const uint32_t depth = 150;
+   fc::temp_directory dir1( graphene::utilities::temp_directory_path() );
+   fc::temp_directory dir2( graphene::utilities::temp_directory_path() );
+   database db1;
+   database db2;
+   db1.open( dir1.path(), [this]() { return genesis_state; }, "TEST" );
+   db2.open( dir2.path(), [this]() { return genesis_state; }, "TEST" );
+
+   auto b = db1.generate_block( db1.get_slot_time(1), db1.get_scheduled_witness(1), init_account_priv_key,
+                                database::skip_nothing );
+   db2.push_block( b );
+
+   // each fork is produced by a minority of the witnesses, so that neither becomes irreversible
+   const auto& active = db1.get_global_properties().active_witnesses;
+   const vector<witness_id_type> witnesses( active.begin(), active.end() );
+   const flat_set<witness_id_type> group1( witnesses.begin(), witnesses.begin() + 3 );
+   const flat_set<witness_id_type> group2( witnesses.begin() + 3, witnesses.begin() + 6 );
+   const auto produce = [this]( database& db, const flat_set<witness_id_type>& group )
+   {
+      uint32_t slot = 1;
+      while( group.find( db.get_scheduled_witness( slot ) ) == group.end() )
+         ++slot;
+      return db.generate_block( db.get_slot_time( slot ), db.get_scheduled_witness( slot ), init_account_priv_key,
+                                database::skip_nothing );
+   };
+
+   for( uint32_t i = 0; i < depth; ++i )
+      produce( db1, group1 );
+   vector<signed_block> fork;
+   fork.reserve( depth + 1 );
+   for( uint32_t i = 0; i <= depth; ++i )
+      fork.push_back( produce( db2, group2 ) );
+
+   // all but the last block of the other fork are not longer than the current chain
+   for( uint32_t i = 0; i < depth; ++i )
+      db1.push_block( fork[i] );
+   FC_ASSERT( db1.head_block_num() == depth + 1 );
+
+   auto start = fc::time_point::now();
+   db1.push_block( fork.back() );
+   auto elapsed = fc::time_point::now() - start;
+   FC_ASSERT( db1.head_block_id() == fork.back().id() );
+   wlog( "Benchmark: switched to a fork ${d} blocks deep in ${ms}ms, ${bps} blocks/s",
+         ("d",depth)("ms",elapsed.count()/1000)("bps",(uint64_t(depth)*2*1000000)/std::max<int64_t>(elapsed.count(),1)) );
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_CASE( merkle_root_benchmark )
+{
+   const uint32_t transactions = 10000;
+   const uint64_t cycles = 10;
+
+   vector<signed_transaction> trxs;
+   trxs.reserve( transactions );
+   for( uint32_t i = 0; i < transactions; ++i )
+   {
+      transfer_operation op;
+      op.from = account_id_type( i );
+      op.to = account_id_type( i + 1 );
+      op.amount = asset( i );
+      signed_transaction trx;
+      trx.operations.push_back( op );
+      trx.expiration = fc::time_point_sec( i );
+      trxs.push_back( trx );
+   }
+
+   // a copy of the block starts without a merkle root, but keeps the cached leaves of its transactions
+   uint64_t cold_us = 0;
+   uint64_t cached_us = 0;
+   for( uint64_t c = 0; c < cycles; ++c )
+   {
+      signed_block cold;
+      cold.transactions.reserve( transactions );
+      for( const auto& trx : trxs )
+      {
+         cold.transactions.emplace_back( trx );
+         cold.transactions.back().operation_results.emplace_back( void_result() );
+      }
+      auto start = fc::time_point::now();
+      const auto cold_root = cold.calculate_merkle_root();
+      cold_us += ( fc::time_point::now() - start ).count();
+
+      signed_block cached;
+      cached.transactions = cold.transactions;
+      start = fc::time_point::now();
+      FC_ASSERT( cached.calculate_merkle_root() == cold_root );
+      cached_us += ( fc::time_point::now() - start ).count();
+   }
+   wlog( "Benchmark: merkle root of ${n} transactions in ${cold}us, ${cached}us with cached leaf digests",
+         ("n",transactions)("cold",cold_us/cycles)("cached",cached_us/cycles) );
+}
+
+BOOST_AUTO_TEST_CASE( block_sigcheck_benchmark )
+{ try {
+   const fc::ecc::private_key signer = fc::ecc::private_key::generate();
+   const uint32_t threads = fc::asio::default_io_service_scope::get_num_threads();
+   const uint32_t skip = database::skip_witness_signature | database::skip_merkle_check
+                       | database::skip_transaction_dupe_check | database::skip_block_size_check;
+
+   for( uint32_t batch : { 1u, 10u, 100u, 1000u } )
+   {
+      const uint32_t total = std::max( batch, 2000u );
+      vector<signed_block> blocks( total / batch );
+      for( uint32_t b = 0; b < blocks.size(); ++b )
+      {
+         blocks[b].transactions.reserve( batch );
+         for( uint32_t i = 0; i < batch; ++i )
+         {
+            transfer_operation op;
+            op.from = account_id_type( b );
+            op.to = account_id_type( i + 1 );
+            op.amount = asset( 1 + i );
+            signed_transaction trx;
+            trx.operations.push_back( op );
+            trx.expiration = db.head_block_time() + fc::minutes(1);
+            trx.sign( signer, db.get_chain_id() );
+            blocks[b].transactions.emplace_back( trx );
+         }
+      }
+
+      auto start = fc::time_point::now();
+      for( const auto& block : blocks )
+         db.precompute_parallel( block, skip ).wait();
+      auto elapsed = fc::time_point::now() - start;
+      const uint64_t sigs = uint64_t( blocks.size() ) * batch;
+      const uint64_t sps = ( sigs * 1000000 ) / std::max<int64_t>( elapsed.count(), 1 );
+      wlog( "Benchmark: ${sps} signatures/s in blocks of ${n} transactions, ${spc}/s per core on ${t} threads",
+            ("sps",sps)("n",batch)("spc",sps/std::max(threads,1u))("t",threads) );
+   }
+} FC_LOG_AND_RETHROW() }
+
 BOOST_AUTO_TEST_SUITE_END()
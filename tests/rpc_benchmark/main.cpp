@@ -0,0 +1,483 @@
+/*
+ * Copyright (c) 2023 R-Squared Labs LLC, and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/**
+ * rpc_benchmark starts an in-process node on a generated genesis, connects a
+ * configurable number of cli_wallet style clients through the websocket API and
+ * lets each of them issue a random mix of transfer, sell_asset and
+ * get_account_history calls for a fixed amount of time. Blocks are produced by
+ * the benchmark itself on the node's main thread, so no witness plugin or
+ * network setup is needed.
+ *
+ * At the end it prints per-call throughput and end-to-end latency percentiles
+ * as well as the CPU time consumed by the node's main (chain) thread and by the
+ * whole process. Optional thresholds turn it into a regression check: the
+ * program exits with status 2 if any of them is violated.
+ */
+
+#include <graphene/app/application.hpp>
+#include <graphene/app/api.hpp>
+
+#include <graphene/account_history/account_history_plugin.hpp>
+#include <graphene/api_helper_indexes/api_helper_indexes.hpp>
+#include <graphene/chain/asset_object.hpp>
+#include <graphene/utilities/key_conversion.hpp>
+#include <graphene/utilities/tempdir.hpp>
+#include <graphene/wallet/wallet.hpp>
+
+#include <fc/io/json.hpp>
+#include <fc/network/http/websocket.hpp>
+#include <fc/rpc/websocket_api.hpp>
+#include <fc/thread/thread.hpp>
+
+#include <boost/algorithm/string.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+
+#include <pthread.h>
+#include <sys/resource.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../common/program_options_util.hpp"
+#include "../common/utils.hpp"
+
+using namespace graphene::app;
+using namespace graphene::chain;
+using namespace std;
+namespace bpo = boost::program_options;
+
+// hack:  import create_example_genesis() even though it's a way, way
+// specific internal detail
+namespace graphene { namespace app { namespace detail {
+genesis_state_type create_example_genesis();
+} } } // graphene::app::detail
+
+namespace {
+
+static const string bench_asset_symbol = "BENCH";
+static const string wallet_password = "benchmark";
+
+enum bench_call
+{
+   call_transfer = 0,
+   call_sell_asset,
+   call_get_account_history,
+   CALL_TYPE_COUNT
+};
+
+static const char* const call_names[CALL_TYPE_COUNT] = { "transfer", "sell_asset", "get_account_history" };
+
+fc::ecc::private_key bench_key( uint32_t i )
+{
+   return fc::ecc::private_key::regenerate( fc::sha256::hash( "bench-" + fc::to_string(i) ) );
+}
+
+string bench_account_name( uint32_t i )
+{
+   return "bench" + fc::to_string(i);
+}
+
+/// Formats an amount given in thousandths of a unit, e.g. 1234 => "1.234"
+string milli_amount( uint64_t milli )
+{
+   std::stringstream ss;
+   ss << milli / 1000 << '.' << std::setw(3) << std::setfill('0') << milli % 1000;
+   return ss.str();
+}
+
+/// CPU time in microseconds consumed by the given clock
+int64_t cpu_clock_usec( clockid_t clock )
+{
+   struct timespec ts;
+   if( clock_gettime( clock, &ts ) != 0 )
+      return 0;
+   return int64_t(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+}
+
+int64_t process_cpu_usec()
+{
+   struct rusage usage;
+   getrusage( RUSAGE_SELF, &usage );
+   return ( int64_t(usage.ru_utime.tv_sec) + usage.ru_stime.tv_sec ) * 1000000
+          + usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+}
+
+/// Parses an operation mix like "transfer=60,sell_asset=20,get_account_history=20"
+std::array<uint32_t, CALL_TYPE_COUNT> parse_mix( const string& mix )
+{
+   std::array<uint32_t, CALL_TYPE_COUNT> weights;
+   weights.fill(0);
+   vector<string> parts;
+   boost::split( parts, mix, boost::is_any_of(",") );
+   for( const string& part : parts )
+   {
+      if( part.empty() )
+         continue;
+      auto pos = part.find('=');
+      FC_ASSERT( pos != string::npos, "Invalid mix entry ${p}, expected name=weight", ("p",part) );
+      string name = boost::trim_copy( part.substr( 0, pos ) );
+      auto itr = std::find_if( std::begin(call_names), std::end(call_names),
+                               [&name]( const char* n ){ return name == n; } );
+      FC_ASSERT( itr != std::end(call_names), "Unknown call ${n} in mix", ("n",name) );
+      weights[ itr - std::begin(call_names) ] = std::stoul( part.substr( pos + 1 ) );
+   }
+   FC_ASSERT( std::accumulate( weights.begin(), weights.end(), 0u ) > 0, "Operation mix must not be empty" );
+   return weights;
+}
+
+/**
+ * A wallet connected to the node through its own websocket connection. All wallet
+ * calls are executed on the client's own fc::thread so that clients run concurrently.
+ */
+class bench_client
+{
+public:
+   bench_client( uint32_t index, const graphene::wallet::wallet_data& initial_data, const fc::path& wallet_dir )
+      : _index(index), _thread( "bench-client-" + fc::to_string(index) ), _rng( index )
+   {
+      _thread.async( [this, &initial_data, &wallet_dir]() {
+         _connection = _websocket_client.connect( initial_data.ws_server );
+         _api_connection = std::make_shared<fc::rpc::websocket_api_connection>( _connection,
+                                                                                GRAPHENE_MAX_NESTED_OBJECTS );
+         auto remote_login_api = _api_connection->get_remote_api< login_api >(1);
+         FC_ASSERT( remote_login_api->login( "", "" ) );
+         _wallet = std::make_shared<graphene::wallet::wallet_api>( initial_data, remote_login_api );
+         _wallet->set_wallet_filename( ( wallet_dir / ( "wallet" + fc::to_string(_index) + ".json" ) )
+                                          .generic_string() );
+         _wallet->set_password( wallet_password );
+         _wallet->unlock( wallet_password );
+      }, "connect" ).wait();
+   }
+
+   ~bench_client()
+   {
+      _thread.async( [this]() {
+         _wallet.reset();
+         _api_connection.reset();
+         _connection.reset();
+      }, "disconnect" ).wait();
+      _thread.quit();
+   }
+
+   /// Runs @p f on the client's thread and waits for the result
+   template<typename Functor>
+   auto call( Functor&& f ) -> decltype( f( std::declval<graphene::wallet::wallet_api&>() ) )
+   {
+      return _thread.async( [this, &f]() { return f( *_wallet ); }, "call" ).wait();
+   }
+
+   /// Issues random calls from the given mix until @p deadline and records their latencies
+   void run( const std::array<uint32_t, CALL_TYPE_COUNT>& weights, uint32_t num_clients, fc::time_point deadline )
+   {
+      _thread.async( [this, &weights, num_clients, deadline]() {
+         std::discrete_distribution<uint32_t> pick( weights.begin(), weights.end() );
+         const string name = bench_account_name( _index );
+         const string peer = bench_account_name( ( _index + 1 ) % num_clients );
+         uint64_t counter = 0;
+         while( fc::time_point::now() < deadline )
+         {
+            const uint32_t which = pick( _rng );
+            // vary the amounts so that otherwise identical transactions get distinct ids
+            const string amount = milli_amount( 1 + counter++ % 100000 );
+            const auto start = fc::time_point::now();
+            try
+            {
+               switch( which )
+               {
+               case call_transfer:
+                  _wallet->transfer( name, peer, amount, GRAPHENE_SYMBOL, "", true );
+                  break;
+               case call_sell_asset:
+                  // alternate sides at the same price so that orders fill against each other
+                  if( counter & 1 )
+                     _wallet->sell_asset( name, amount, GRAPHENE_SYMBOL, amount, bench_asset_symbol,
+                                          0, false, true );
+                  else
+                     _wallet->sell_asset( name, amount, bench_asset_symbol, amount, GRAPHENE_SYMBOL,
+                                          0, false, true );
+                  break;
+               case call_get_account_history:
+                  _wallet->get_account_history( name, 20 );
+                  break;
+               }
+               latencies[which].push_back( ( fc::time_point::now() - start ).count() );
+            }
+            catch( const fc::exception& e )
+            {
+               ++failures[which];
+               if( failures[which] <= 3 )
+                  wlog( "${c} failed: ${e}", ("c",call_names[which])("e",e.to_string()) );
+            }
+         }
+      }, "run" ).wait();
+   }
+
+   std::array<vector<int64_t>, CALL_TYPE_COUNT> latencies;
+   std::array<uint64_t, CALL_TYPE_COUNT> failures {};
+
+private:
+   uint32_t                                             _index;
+   fc::thread                                           _thread;
+   std::mt19937                                         _rng;
+   fc::http::websocket_client                           _websocket_client;
+   fc::http::websocket_connection_ptr                   _connection;
+   std::shared_ptr<fc::rpc::websocket_api_connection>   _api_connection;
+   std::shared_ptr<graphene::wallet::wallet_api>        _wallet;
+};
+
+int64_t percentile( const vector<int64_t>& sorted, uint32_t p )
+{
+   if( sorted.empty() )
+      return 0;
+   return sorted[ std::min<size_t>( sorted.size() - 1, sorted.size() * p / 100 ) ];
+}
+
+} // anonymous namespace
+
+int main( int argc, char** argv )
+{
+   try
+   {
+      bpo::options_description cli_options("R-Squared RPC benchmark");
+      cli_options.add_options()
+            ("help,h", "Print this help message and exit.")
+            ("data-dir", bpo::value<boost::filesystem::path>(),
+                  "Directory for the node database and wallets (default: a temporary directory)")
+            ("clients,c", bpo::value<uint32_t>()->default_value(4), "Number of concurrent RPC clients")
+            ("duration,d", bpo::value<uint32_t>()->default_value(30), "Measurement duration in seconds")
+            ("mix,m", bpo::value<string>()->default_value("transfer=60,sell_asset=20,get_account_history=20"),
+                  "Weighted mix of calls issued by every client")
+            ("block-interval-ms", bpo::value<uint32_t>()->default_value(1000),
+                  "Wall clock time between two generated blocks")
+            ("min-calls-per-second", bpo::value<double>(),
+                  "Exit with an error if the total call rate falls below this value")
+            ("max-p99-ms", bpo::value<double>(),
+                  "Exit with an error if the 99th latency percentile of any call type exceeds this value")
+            ;
+
+      bpo::variables_map options;
+      try
+      {
+         bpo::store( bpo::parse_command_line(argc, argv, cli_options), options );
+         bpo::notify( options );
+      }
+      catch (const bpo::error& e)
+      {
+         std::cerr << "rpc_benchmark:  error parsing command line: " << e.what() << "\n";
+         return 1;
+      }
+
+      if( options.count("help") )
+      {
+         std::cout << cli_options << "\n";
+         return 0;
+      }
+
+      const uint32_t num_clients = options["clients"].as<uint32_t>();
+      const uint32_t duration = options["duration"].as<uint32_t>();
+      const uint32_t block_interval_ms = options["block-interval-ms"].as<uint32_t>();
+      const auto weights = parse_mix( options["mix"].as<string>() );
+      FC_ASSERT( num_clients > 0, "Need at least one client" );
+
+      fc::temp_directory temp_dir( graphene::utilities::temp_directory_path() );
+      fc::path data_dir = temp_dir.path();
+      if( options.count("data-dir") )
+      {
+         data_dir = options["data-dir"].as<boost::filesystem::path>();
+         if( data_dir.is_relative() )
+            data_dir = fc::current_path() / data_dir;
+      }
+
+      // generate a genesis with one pre-registered account per client
+      genesis_state_type genesis = graphene::app::detail::create_example_genesis();
+      for( uint32_t i = 0; i < num_clients; ++i )
+      {
+         auto key = bench_key(i).get_public_key();
+         genesis.initial_accounts.emplace_back( bench_account_name(i), key, key, false );
+      }
+      fc::create_directories( data_dir );
+      const fc::path genesis_file = data_dir / "genesis.json";
+      fc::json::save_to_file( genesis, genesis_file );
+
+      const int rpc_port = fc::network::get_available_port();
+      FC_ASSERT( rpc_port > 0, "Unable to find a free port for the RPC endpoint" );
+
+      auto node = std::make_shared<application>();
+      node->register_plugin< graphene::account_history::account_history_plugin >( true );
+      node->register_plugin< graphene::api_helper_indexes::api_helper_indexes >( true );
+
+      auto sharable_cfg = std::make_shared<bpo::variables_map>();
+      auto& cfg = *sharable_cfg;
+      fc::set_option( cfg, "rpc-endpoint", string("127.0.0.1:") + std::to_string(rpc_port) );
+      fc::set_option( cfg, "p2p-endpoint", string("127.0.0.1:0") );
+      fc::set_option( cfg, "genesis-json", boost::filesystem::path( genesis_file.generic_string() ) );
+      fc::set_option( cfg, "seed-nodes", string("[]") );
+      node->initialize( data_dir / "node", sharable_cfg );
+      node->startup();
+
+      auto db = node->chain_database();
+      const auto committee_key = fc::ecc::private_key::regenerate( fc::sha256::hash( string("rsquaredchp1") ) );
+      auto produce_block = [&db, &committee_key]() {
+         db->generate_block( db->get_slot_time(1), db->get_scheduled_witness(1), committee_key,
+                             database::skip_nothing );
+      };
+
+      graphene::wallet::wallet_data wdata;
+      wdata.chain_id = db->get_chain_id();
+      wdata.ws_server = "ws://127.0.0.1:" + fc::to_string(rpc_port);
+
+      // fund the bench accounts with core and with a freshly created UIA to trade against
+      std::cerr << "rpc_benchmark:  setting up " << num_clients << " clients\n";
+      vector<std::unique_ptr<bench_client>> clients;
+      {
+         bench_client funder( num_clients, wdata, data_dir );
+         funder.call( []( graphene::wallet::wallet_api& w ) {
+            const string wif = graphene::utilities::key_to_wif(
+                  fc::ecc::private_key::regenerate( fc::sha256::hash( string("rsquaredchp1") ) ) );
+            w.import_key( "rsquaredchp1", wif );
+            w.import_balance( "rsquaredchp1", { wif }, true );
+            asset_options opts;
+            opts.max_supply = GRAPHENE_MAX_SHARE_SUPPLY;
+            opts.issuer_permissions = DEFAULT_UIA_ASSET_ISSUER_PERMISSION;
+            opts.flags = 0;
+            opts.core_exchange_rate = price( asset(1), asset(1, asset_id_type(1)) );
+            w.create_asset( "rsquaredchp1", bench_asset_symbol, GRAPHENE_BLOCKCHAIN_PRECISION_DIGITS, opts, {}, true );
+            return 0;
+         } );
+         produce_block();
+         funder.call( [num_clients]( graphene::wallet::wallet_api& w ) {
+            for( uint32_t i = 0; i < num_clients; ++i )
+            {
+               w.transfer( "rsquaredchp1", bench_account_name(i), "1000000", GRAPHENE_SYMBOL, "", true );
+               w.issue_asset( bench_account_name(i), "1000000", bench_asset_symbol, "", true );
+            }
+            return 0;
+         } );
+         produce_block();
+      }
+      for( uint32_t i = 0; i < num_clients; ++i )
+      {
+         clients.emplace_back( new bench_client( i, wdata, data_dir ) );
+         clients.back()->call( [i]( graphene::wallet::wallet_api& w ) {
+            return w.import_key( bench_account_name(i), graphene::utilities::key_to_wif( bench_key(i) ) );
+         } );
+      }
+
+      // measure
+      std::cerr << "rpc_benchmark:  running for " << duration << " seconds\n";
+      clockid_t node_clock;
+      FC_ASSERT( pthread_getcpuclockid( pthread_self(), &node_clock ) == 0 );
+      const int64_t node_cpu_start = cpu_clock_usec( node_clock );
+      const int64_t process_cpu_start = process_cpu_usec();
+      const auto start = fc::time_point::now();
+      const auto deadline = start + fc::seconds( duration );
+
+      vector<fc::future<void>> running;
+      for( auto& client : clients )
+      {
+         bench_client* c = client.get();
+         running.push_back( fc::async( [c, &weights, num_clients, deadline]() {
+            c->run( weights, num_clients, deadline );
+         }, "bench-run" ) );
+      }
+      uint32_t blocks = 0;
+      while( fc::time_point::now() < deadline )
+      {
+         fc::usleep( fc::milliseconds( block_interval_ms ) );
+         produce_block();
+         ++blocks;
+      }
+      for( auto& f : running )
+         f.wait();
+
+      const double elapsed = ( fc::time_point::now() - start ).count() / 1000000.0;
+      const int64_t node_cpu = cpu_clock_usec( node_clock ) - node_cpu_start;
+      const int64_t process_cpu = process_cpu_usec() - process_cpu_start;
+
+      // report
+      bool failed_threshold = false;
+      uint64_t total_calls = 0;
+      std::cout << std::fixed << std::setprecision(2);
+      std::cout << "clients: " << num_clients << "  duration: " << elapsed << "s  blocks: " << blocks
+                << "  head block: " << db->head_block_num() << "\n";
+      std::cout << std::left << std::setw(22) << "call" << std::right
+                << std::setw(10) << "calls" << std::setw(8) << "errors" << std::setw(10) << "calls/s"
+                << std::setw(10) << "p50 ms" << std::setw(10) << "p90 ms" << std::setw(10) << "p99 ms"
+                << std::setw(10) << "max ms" << "\n";
+      for( uint32_t which = 0; which < CALL_TYPE_COUNT; ++which )
+      {
+         vector<int64_t> all;
+         uint64_t errors = 0;
+         for( const auto& client : clients )
+         {
+            all.insert( all.end(), client->latencies[which].begin(), client->latencies[which].end() );
+            errors += client->failures[which];
+         }
+         if( all.empty() && errors == 0 )
+            continue;
+         std::sort( all.begin(), all.end() );
+         total_calls += all.size();
+         const double p99_ms = percentile( all, 99 ) / 1000.0;
+         std::cout << std::left << std::setw(22) << call_names[which] << std::right
+                   << std::setw(10) << all.size() << std::setw(8) << errors
+                   << std::setw(10) << all.size() / elapsed
+                   << std::setw(10) << percentile( all, 50 ) / 1000.0
+                   << std::setw(10) << percentile( all, 90 ) / 1000.0
+                   << std::setw(10) << p99_ms
+                   << std::setw(10) << ( all.empty() ? 0 : all.back() ) / 1000.0 << "\n";
+         if( options.count("max-p99-ms") && p99_ms > options["max-p99-ms"].as<double>() )
+         {
+            std::cerr << "rpc_benchmark:  p99 latency of " << call_names[which] << " exceeds threshold\n";
+            failed_threshold = true;
+         }
+      }
+      const double calls_per_second = total_calls / elapsed;
+      std::cout << "total: " << total_calls << " calls, " << calls_per_second << " calls/s\n";
+      std::cout << "node main thread CPU: " << node_cpu / 1000000.0 << "s ("
+                << 100.0 * node_cpu / 1000000.0 / elapsed << "%)  process CPU: "
+                << process_cpu / 1000000.0 << "s (" << 100.0 * process_cpu / 1000000.0 / elapsed << "%)\n";
+      if( options.count("min-calls-per-second") && calls_per_second < options["min-calls-per-second"].as<double>() )
+      {
+         std::cerr << "rpc_benchmark:  call rate below threshold\n";
+         failed_threshold = true;
+      }
+
+      clients.clear();
+      db.reset();
+      node.reset();
+      return failed_threshold ? 2 : 0;
+   }
+   catch ( const fc::exception& e )
+   {
+      std::cerr << e.to_detail_string() << "\n";
+      return 1;
+   }
+}
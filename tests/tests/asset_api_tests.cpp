@@ -63,6 +63,49 @@ BOOST_AUTO_TEST_CASE( asset_holders )
    BOOST_CHECK(holders[2].name == "alice");
    BOOST_CHECK(holders[3].name == "dan");
 }
+
+BOOST_AUTO_TEST_CASE( asset_holders_require_plugin )
+{
+   graphene::app::asset_api asset_api(app);
+   const std::string core_id = std::string( static_cast<object_id_type>(asset_id_type()) );
+
+   // the holder lists are only served by the api_helper_indexes plugin
+   GRAPHENE_CHECK_THROW( asset_api.get_asset_holders( core_id, 0, 100 ), fc::exception );
+   GRAPHENE_CHECK_THROW( asset_api.get_asset_holders_count( core_id ), fc::exception );
+   GRAPHENE_CHECK_THROW( asset_api.get_all_asset_holders(), fc::exception );
+}
+
+BOOST_AUTO_TEST_CASE( asset_holders_follow_pending_and_undo )
+{
+   graphene::app::asset_api asset_api(app);
+   const std::string core_id = std::string( static_cast<object_id_type>(asset_id_type()) );
+
+   auto dan = create_account("dan");
+   auto bob = create_account("bob");
+   transfer(account_id_type()(db), dan, asset(100));
+   transfer(account_id_type()(db), bob, asset(300));
+   generate_block();
+
+   vector<account_asset_balance> holders = asset_api.get_asset_holders( core_id, 1, 100 );
+   BOOST_REQUIRE_EQUAL( holders.size(), 2u );
+   BOOST_CHECK( holders[0].name == "bob" );
+   BOOST_CHECK( holders[1].name == "dan" );
+
+   // a pending transfer is seen without waiting for the next block
+   transfer(account_id_type()(db), dan, asset(500));
+   holders = asset_api.get_asset_holders( core_id, 1, 100 );
+   BOOST_REQUIRE_EQUAL( holders.size(), 2u );
+   BOOST_CHECK( holders[0].name == "dan" );
+   BOOST_CHECK_EQUAL( holders[0].amount.value, 600 );
+
+   // and dropping it restores the previous order
+   db.clear_pending();
+   holders = asset_api.get_asset_holders( core_id, 1, 100 );
+   BOOST_REQUIRE_EQUAL( holders.size(), 2u );
+   BOOST_CHECK( holders[0].name == "bob" );
+   BOOST_CHECK_EQUAL( holders[1].amount.value, 100 );
+}
+
 BOOST_AUTO_TEST_CASE( api_limit_get_asset_holders )
 {
    graphene::app::asset_api asset_api(app);
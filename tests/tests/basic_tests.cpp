@@ -630,4 +630,88 @@ BOOST_AUTO_TEST_CASE( bitasset_feed_expiration_test )
    BOOST_CHECK( !o.feed_is_expired( now ) );
 }
 
+/**
+ * Maintenance only modifies bitassets whose median feed would change, check that this
+ * gives exactly the same objects as recalculating every time.
+ */
+BOOST_AUTO_TEST_CASE( median_feed_skip_unchanged_test )
+{
+   std::mt19937 rng( 20261018 );
+   const auto random = [&rng]( uint32_t n ) { return uint32_t( rng() % n ); };
+
+   asset_bitasset_data_object full;
+   full.options.feed_lifetime_sec = 3 * 3600;
+   full.options.minimum_feeds = 3;
+   asset_bitasset_data_object incremental = full;
+
+   time_point_sec now( 1600000000 );
+   uint32_t skipped = 0;
+   uint32_t applied = 0;
+   for( uint32_t step = 0; step < 20000; ++step )
+   {
+      const uint32_t action = random( 100 );
+      if( action < 40 )
+      {
+         // small amounts with a random multiplier produce equal prices with different representations
+         const int64_t mult = 1 + random( 3 );
+         price_feed_with_icr feed;
+         feed.settlement_price = asset( mult * ( 1 + random( 5 ) ), asset_id_type(1) ) / asset( mult * 2 );
+         feed.core_exchange_rate = asset( mult * ( 1 + random( 5 ) ), asset_id_type(1) ) / asset( mult * 3 );
+         feed.maintenance_collateral_ratio = 1750 + random( 3 ) * 10;
+         feed.maximum_short_squeeze_ratio = 1100 + random( 3 ) * 10;
+         feed.initial_collateral_ratio = 1700 + random( 4 ) * 50;
+         const account_id_type producer( random( 15 ) );
+         full.feeds[producer] = std::make_pair( now, feed );
+         incremental.feeds[producer] = std::make_pair( now, feed );
+         // the publish feed evaluator always recalculates
+         full.update_median_feeds( now, now );
+         incremental.update_median_feeds( now, now );
+      }
+      else if( action < 45 && !full.feeds.empty() )
+      {
+         const account_id_type producer( random( 15 ) );
+         full.feeds.erase( producer );
+         incremental.feeds.erase( producer );
+      }
+      else if( action < 47 )
+      {
+         const uint8_t minimum_feeds = 1 + random( 5 );
+         full.options.minimum_feeds = minimum_feeds;
+         incremental.options.minimum_feeds = minimum_feeds;
+      }
+      else if( action < 49 )
+      {
+         optional<uint16_t> mcr;
+         if( random( 2 ) )
+            mcr = 1800;
+         full.options.extensions.value.maintenance_collateral_ratio = mcr;
+         incremental.options.extensions.value.maintenance_collateral_ratio = mcr;
+      }
+      else if( action < 50 )
+      {
+         full.feed_cer_updated = incremental.feed_cer_updated = false;
+      }
+      else if( action < 80 )
+      {
+         now += random( 1800 );
+      }
+      else
+      {
+         // maintenance
+         full.update_median_feeds( now, now );
+         const auto result = incremental.calculate_median_feeds( now );
+         if( incremental.median_feeds_changed( result ) )
+         {
+            incremental.apply_median_feeds( result );
+            ++applied;
+         }
+         else
+            ++skipped;
+      }
+      BOOST_REQUIRE( fc::raw::pack( full ) == fc::raw::pack( incremental ) );
+   }
+   BOOST_CHECK_GT( skipped, 0u );
+   BOOST_CHECK_GT( applied, 0u );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
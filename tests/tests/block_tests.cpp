@@ -194,6 +194,71 @@ BOOST_AUTO_TEST_CASE( generate_empty_blocks )
    }
 }
 
+BOOST_AUTO_TEST_CASE( single_witness_schedule )
+{
+   try {
+      fc::temp_directory data_dir( graphene::utilities::temp_directory_path() );
+      auto init_account_priv_key = fc::ecc::private_key::regenerate(fc::sha256::hash(string("null_key")) );
+
+      database db;
+      db.open( data_dir.path(), [&init_account_priv_key]() {
+         genesis_state_type genesis_state;
+         genesis_state.initial_timestamp = time_point_sec( GRAPHENE_TESTING_GENESIS_TIMESTAMP );
+         genesis_state.initial_active_witnesses = 1;
+         genesis_state.immutable_parameters.min_committee_member_count = 1;
+         genesis_state.immutable_parameters.min_witness_count = 1;
+         genesis_state.initial_accounts.emplace_back( "init0", init_account_priv_key.get_public_key(),
+                                                      init_account_priv_key.get_public_key(), true );
+         genesis_state.initial_committee_candidates.push_back( {"init0"} );
+         genesis_state.initial_witness_candidates.push_back( {"init0", init_account_priv_key.get_public_key()} );
+         genesis_state.initial_parameters.get_mutable_fees().zero_all_fees();
+         return genesis_state;
+      }, "TEST" );
+
+      BOOST_REQUIRE_EQUAL( db.get_global_properties().active_witnesses.size(), 1u );
+      const witness_id_type witness = *db.get_global_properties().active_witnesses.begin();
+      const vector< witness_id_type > expected_schedule( 1, witness );
+
+      // every block starts a new round, but the schedule of a lone witness never changes
+      uint32_t notifications = 0;
+      uint32_t schedule_changes = 0;
+      boost::signals2::scoped_connection conn = db.changed_objects.connect(
+         [&notifications,&schedule_changes]( const vector<object_id_type>& ids, const flat_set<account_id_type>& ) {
+            ++notifications;
+            schedule_changes += std::count( ids.begin(), ids.end(), object_id_type( witness_schedule_id_type() ) );
+         } );
+
+      for( uint32_t i = 0; i < 20; ++i )
+      {
+         BOOST_CHECK( db.get_scheduled_witness(1) == witness );
+         signed_block b = db.generate_block( db.get_slot_time(1), db.get_scheduled_witness(1),
+                                             init_account_priv_key, database::skip_nothing );
+         BOOST_CHECK( b.witness == witness );
+         BOOST_CHECK( db.get_shuffled_witnesses() == expected_schedule );
+      }
+      BOOST_CHECK_GT( notifications, 0u );
+      BOOST_CHECK_EQUAL( schedule_changes, 0u );
+
+      // nor across a maintenance interval, with missed slots in between
+      const uint32_t slot = db.get_slot_at_time( db.get_dynamic_global_properties().next_maintenance_time );
+      db.generate_block( db.get_slot_time( slot ), db.get_scheduled_witness( slot ), init_account_priv_key,
+                         database::skip_nothing );
+      for( uint32_t i = 0; i < 5; ++i )
+      {
+         BOOST_CHECK( db.get_scheduled_witness(1) == witness );
+         db.generate_block( db.get_slot_time(1), db.get_scheduled_witness(1), init_account_priv_key,
+                            database::skip_nothing );
+      }
+      BOOST_CHECK( db.get_global_properties().active_witnesses == flat_set< witness_id_type >( { witness } ) );
+      BOOST_CHECK( db.get_shuffled_witnesses() == expected_schedule );
+      BOOST_CHECK_EQUAL( schedule_changes, 0u );
+      BOOST_CHECK_EQUAL( db.head_block_num(), 26u );
+   } catch (fc::exception& e) {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
 BOOST_AUTO_TEST_CASE( undo_block )
 {
    try {
@@ -1400,10 +1465,10 @@ BOOST_AUTO_TEST_CASE( genesis_reserve_ids )
 BOOST_FIXTURE_TEST_CASE( miss_some_blocks, database_fixture )
 { try {
    // Witnesses scheduled incorrectly in genesis block - reschedule
-   generate_blocks( witness_schedule_id_type()(db).current_shuffled_witnesses.size() );
+   generate_blocks( db.get_shuffled_witnesses().size() );
    generate_blocks( db.get_dynamic_global_properties().next_maintenance_time );
 
-   std::vector<witness_id_type> witnesses = witness_schedule_id_type()(db).current_shuffled_witnesses;
+   std::vector<witness_id_type> witnesses = db.get_shuffled_witnesses();
    BOOST_CHECK_EQUAL( INITIAL_WITNESS_COUNT, witnesses.size() );
    // database_fixture constructor calls generate_block once, signed by witnesses[0]
    generate_block(); // witnesses[1]
@@ -1423,12 +1488,12 @@ BOOST_FIXTURE_TEST_CASE( miss_many_blocks, database_fixture )
    try
    {
       // Witnesses scheduled incorrectly in genesis block - reschedule
-      generate_blocks( witness_schedule_id_type()(db).current_shuffled_witnesses.size() );
+      generate_blocks( db.get_shuffled_witnesses().size() );
       generate_blocks( db.get_dynamic_global_properties().next_maintenance_time );
 
       auto get_misses = []( database& db ) {
          std::map< witness_id_type, uint32_t > misses;
-         for( const auto& witness_id : witness_schedule_id_type()(db).current_shuffled_witnesses )
+         for( const auto& witness_id : db.get_shuffled_witnesses() )
             misses[witness_id] = witness_id(db).total_missed;
          return misses;
       };
@@ -1458,6 +1523,55 @@ BOOST_FIXTURE_TEST_CASE( miss_many_blocks, database_fixture )
    }
 }
 
+BOOST_FIXTURE_TEST_CASE( witness_schedule_rounds, database_fixture )
+{ try {
+   // let the first maintenance settle the active witnesses, and a round start with them
+   generate_blocks( db.get_dynamic_global_properties().next_maintenance_time );
+   generate_blocks( db.get_global_properties().active_witnesses.size() );
+
+   uint32_t schedule_changes = 0;
+   boost::signals2::scoped_connection conn = db.changed_objects.connect(
+      [&schedule_changes]( const vector<object_id_type>& ids, const flat_set<account_id_type>& ) {
+         schedule_changes += std::count( ids.begin(), ids.end(), object_id_type( witness_schedule_id_type() ) );
+      } );
+
+   const vector< witness_id_type > active( db.get_global_properties().active_witnesses.begin(),
+                                           db.get_global_properties().active_witnesses.end() );
+   vector< vector< witness_id_type > > rounds;
+   while( rounds.size() < 3 )
+   {
+      generate_block();
+      if( db.head_block_num() % active.size() != 0 )
+         continue;
+
+      // the round is shuffled exactly like the stored schedule used to be
+      vector< witness_id_type > expected = active;
+      const uint64_t now_hi = uint64_t( db.head_block_time().sec_since_epoch() ) << 32;
+      for( uint32_t i = 0; i < expected.size(); ++i )
+      {
+         uint64_t k = now_hi + uint64_t(i)*2685821657736338717ULL;
+         k ^= (k >> 12);
+         k ^= (k << 25);
+         k ^= (k >> 27);
+         k *= 2685821657736338717ULL;
+         std::swap( expected[i], expected[ i + k % ( expected.size() - i ) ] );
+      }
+      const vector< witness_id_type > shuffled = db.get_shuffled_witnesses();
+      BOOST_CHECK( shuffled == expected );
+
+      // every active witness produces once per round
+      vector< witness_id_type > sorted = shuffled;
+      std::sort( sorted.begin(), sorted.end() );
+      BOOST_CHECK( sorted == active );
+      rounds.push_back( shuffled );
+   }
+   BOOST_CHECK( rounds[0] != rounds[1] || rounds[1] != rounds[2] );
+
+   // the schedule object is not written while the active witnesses stay the same
+   BOOST_CHECK_EQUAL( schedule_changes, 0u );
+   BOOST_CHECK( db.get_witness_schedule_object().current_witnesses == active );
+} FC_LOG_AND_RETHROW() }
+
 BOOST_FIXTURE_TEST_CASE( update_account_keys, database_fixture )
 {
    try
@@ -1874,4 +1988,63 @@ BOOST_FIXTURE_TEST_CASE( block_size_test, database_fixture )
    }
 }
 
+BOOST_FIXTURE_TEST_CASE( reuse_pending_signature_keys, database_fixture )
+{
+   try
+   {
+      ACTORS( (alice) );
+      transfer( committee_account, alice_id, asset(10000) );
+
+      transfer_operation op;
+      op.from = alice_id;
+      op.to = committee_account;
+      op.amount = asset(1);
+      signed_transaction trx;
+      trx.operations.push_back( op );
+      set_expiration( db, trx );
+      sign( trx, alice_private_key );
+
+      precomputable_transaction pending( trx );
+      const auto keys = pending.get_signature_keys( db.get_chain_id() );
+      BOOST_CHECK( pending.has_signature_keys() );
+
+      // same id but different signatures, the keys must be recovered again
+      precomputable_transaction other_sigs( trx );
+      other_sigs.signatures.push_back( other_sigs.signatures.front() );
+      BOOST_CHECK( !other_sigs.reuse_signature_keys( pending.signatures, keys ) );
+      BOOST_CHECK( !other_sigs.has_signature_keys() );
+
+      precomputable_transaction included( trx );
+      BOOST_CHECK( included.reuse_signature_keys( pending.signatures, keys ) );
+      BOOST_CHECK( included.get_signature_keys( db.get_chain_id() ) == keys );
+      BOOST_CHECK( !included.reuse_signature_keys( pending.signatures, keys ) );
+
+      // nothing was pushed yet
+      signed_block blk;
+      blk.transactions.emplace_back( trx );
+      BOOST_CHECK_EQUAL( db.reuse_recovered_signature_keys( blk ), 0u );
+      BOOST_CHECK( !blk.transactions.front().has_signature_keys() );
+
+      // the keys recovered when the transaction was pushed are taken over, nothing is recovered
+      PUSH_TX( db, trx );
+      blk.transactions.emplace_back( other_sigs );
+      BOOST_CHECK_EQUAL( db.reuse_recovered_signature_keys( blk ), 1u );
+      BOOST_CHECK( blk.transactions.front().has_signature_keys() );
+      BOOST_CHECK( blk.transactions.front().get_signature_keys( db.get_chain_id() ) == keys );
+      BOOST_CHECK( !blk.transactions.back().has_signature_keys() );
+
+      // the keys are forgotten once the transaction is in a block
+      auto b = generate_block();
+      BOOST_REQUIRE_EQUAL( b.transactions.size(), 1u );
+      signed_block copy = fc::raw::unpack<signed_block>( fc::raw::pack( b ) );
+      BOOST_CHECK_EQUAL( db.reuse_recovered_signature_keys( copy ), 0u );
+      BOOST_CHECK( !copy.transactions.front().has_signature_keys() );
+   }
+   catch( const fc::exception& e )
+   {
+      edump( (e.to_detail_string()) );
+      throw;
+   }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
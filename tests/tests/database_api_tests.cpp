@@ -1327,4 +1327,42 @@ BOOST_AUTO_TEST_CASE( verify_authority_multiple_accounts )
    }
 }
 
+BOOST_AUTO_TEST_CASE( get_vesting_balances_by_asset_and_type )
+{ try {
+   ACTORS( (alice)(bob) );
+   const asset_id_type usd_id = create_user_issued_asset( "USDBIT" ).id;
+
+   auto create_vesting = [this]( account_id_type owner, asset balance, vesting_balance_type type ) {
+      return db.create<vesting_balance_object>( [&]( vesting_balance_object& vbo ) {
+         vbo.owner = owner;
+         vbo.balance = balance;
+         vbo.balance_type = type;
+      }).id;
+   };
+   const auto core_cashback = create_vesting( alice_id, asset(100), vesting_balance_type::cashback );
+   const auto core_worker = create_vesting( alice_id, asset(200), vesting_balance_type::worker );
+   const auto usd_fees = create_vesting( alice_id, asset(300, usd_id), vesting_balance_type::market_fee_sharing );
+   create_vesting( bob_id, asset(400), vesting_balance_type::cashback );
+
+   graphene::app::database_api db_api( db );
+
+   BOOST_CHECK_EQUAL( db_api.get_vesting_balances( "alice" ).size(), 3u );
+
+   auto vbos = db_api.get_vesting_balances( "alice", std::string( GRAPHENE_SYMBOL ) );
+   BOOST_REQUIRE_EQUAL( vbos.size(), 2u );
+   BOOST_CHECK( vbos[0].id == core_cashback );
+   BOOST_CHECK( vbos[1].id == core_worker );
+
+   vbos = db_api.get_vesting_balances( "alice", std::string( "USDBIT" ), vesting_balance_type::market_fee_sharing );
+   BOOST_REQUIRE_EQUAL( vbos.size(), 1u );
+   BOOST_CHECK( vbos[0].id == usd_fees );
+
+   vbos = db_api.get_vesting_balances( "alice", std::string( "USDBIT" ), vesting_balance_type::cashback );
+   BOOST_CHECK( vbos.empty() );
+
+   vbos = db_api.get_vesting_balances( "alice", optional<std::string>(), vesting_balance_type::worker );
+   BOOST_REQUIRE_EQUAL( vbos.size(), 1u );
+   BOOST_CHECK( vbos[0].id == core_worker );
+} FC_LOG_AND_RETHROW() }
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -29,9 +29,12 @@
 
 #include <graphene/chain/account_object.hpp>
 #include <graphene/chain/proposal_object.hpp>
+#include <graphene/chain/transaction_history_object.hpp>
 
 #include <fc/crypto/digest.hpp>
 
+#include <thread>
+
 #include "../common/database_fixture.hpp"
 
 using namespace graphene::chain;
@@ -281,4 +284,433 @@ BOOST_AUTO_TEST_CASE( required_approval_index_test ) // see https://github.com/b
 
 } FC_LOG_AND_RETHROW() }
 
+BOOST_AUTO_TEST_CASE( precheck_transaction_test )
+{ try {
+   ACTORS( (alice) );
+   transfer_operation op;
+   op.from = account_id_type();
+   op.to = alice_id;
+   op.amount = asset(1);
+   signed_transaction trx;
+   trx.operations.push_back( op );
+   set_expiration( db, trx );
+   sign( trx, init_account_priv_key );
+
+   db.precheck_transaction( trx );
+   PUSH_TX( db, trx );
+   const size_t undo_size = db._undo_db.size();
+
+   // rejected without starting an undo session
+   GRAPHENE_CHECK_THROW( db.precheck_transaction( trx ), duplicate_transaction );
+   GRAPHENE_CHECK_THROW( PUSH_TX( db, trx ), duplicate_transaction );
+   BOOST_CHECK_EQUAL( db._undo_db.size(), undo_size );
+
+   signed_transaction expired = trx;
+   expired.expiration = db.head_block_time() - fc::seconds(1);
+   GRAPHENE_CHECK_THROW( db.precheck_transaction( expired ), fc::exception );
+   GRAPHENE_CHECK_THROW( PUSH_TX( db, expired ), fc::exception );
+
+   signed_transaction other_fork = trx;
+   other_fork.ref_block_prefix ^= 1;
+   GRAPHENE_CHECK_THROW( db.precheck_transaction( other_fork ), fc::exception );
+   GRAPHENE_CHECK_THROW( PUSH_TX( db, other_fork ), fc::exception );
+   BOOST_CHECK_EQUAL( db._undo_db.size(), undo_size );
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_CASE( recent_transaction_lookup_test )
+{ try {
+   ACTORS( (alice) );
+   transfer_operation op;
+   op.from = account_id_type();
+   op.to = alice_id;
+   op.amount = asset(7);
+   signed_transaction trx;
+   trx.operations.push_back( op );
+   set_expiration( db, trx );
+   sign( trx, init_account_priv_key );
+   PUSH_TX( db, trx );
+
+   // pending transactions are served from the pending pool
+   const auto& by_trx_id = db.get_index_type< transaction_index >().indices().get< by_trx_id >();
+   BOOST_REQUIRE( by_trx_id.find( trx.id() ) != by_trx_id.end() );
+   BOOST_CHECK_EQUAL( by_trx_id.find( trx.id() )->block_num, db.head_block_num() + 1 );
+   BOOST_CHECK( db.get_recent_transaction( trx.id() ).id() == trx.id() );
+
+   // included transactions are read from their block
+   generate_block();
+   BOOST_CHECK_EQUAL( by_trx_id.find( trx.id() )->block_num, db.head_block_num() );
+   const signed_transaction recent = db.get_recent_transaction( trx.id() );
+   BOOST_CHECK( recent.id() == trx.id() );
+   BOOST_CHECK_EQUAL( recent.operations.front().get< transfer_operation >().amount.amount.value, 7 );
+   BOOST_CHECK_EQUAL( recent.signatures.size(), 1u );
+
+   BOOST_CHECK_THROW( db.get_recent_transaction( transaction_id_type() ), fc::exception );
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_CASE( pending_transactions_limits_test )
+{ try {
+   ACTORS( (alice)(bob) );
+   fund( alice, asset(1000000) );
+   fund( bob, asset(1000000) );
+   generate_block();
+
+   auto make_transfer = [this]( const account_id_type& from, const account_id_type& to,
+                                const fc::ecc::private_key& key, int64_t amount ) {
+      transfer_operation op;
+      op.from = from;
+      op.to = to;
+      op.amount = asset(amount);
+      signed_transaction trx;
+      trx.operations.push_back( op );
+      set_expiration( db, trx );
+      db.current_fee_schedule().set_fee( trx.operations.back() );
+      sign( trx, key );
+      return trx;
+   };
+
+   pending_transactions_limits limits;
+   limits.max_count = 2;
+   limits.max_per_account = 1;
+   db.set_pending_transactions_limits( limits );
+
+   PUSH_TX( db, make_transfer( alice_id, bob_id, alice_private_key, 1 ) );
+   GRAPHENE_CHECK_THROW( PUSH_TX( db, make_transfer( alice_id, bob_id, alice_private_key, 2 ) ), fc::exception );
+   BOOST_CHECK_EQUAL( db.get_pending_transactions_stats().rejected_account_limit, 1u );
+
+   PUSH_TX( db, make_transfer( bob_id, alice_id, bob_private_key, 1 ) );
+   GRAPHENE_CHECK_THROW( PUSH_TX( db, make_transfer( committee_account, alice_id, init_account_priv_key, 1 ) ),
+                         fc::exception );
+   BOOST_CHECK_EQUAL( db.get_pending_transactions_stats().rejected_pool_full, 1u );
+   BOOST_CHECK_EQUAL( db.get_pending_transactions_stats().count, 2u );
+   BOOST_CHECK_GT( db.get_pending_transactions_stats().size, 0u );
+
+   // producing a block empties the pool
+   generate_block();
+   BOOST_CHECK_EQUAL( db.get_pending_transactions_stats().last_block_included, 2u );
+   BOOST_CHECK_EQUAL( db.get_pending_transactions_stats().last_block_postponed, 0u );
+   BOOST_CHECK_EQUAL( db.get_pending_transactions_stats().count, 0u );
+   BOOST_CHECK_EQUAL( db.get_pending_transactions_stats().size, 0u );
+   PUSH_TX( db, make_transfer( alice_id, bob_id, alice_private_key, 2 ) );
+
+   db.set_pending_transactions_limits( pending_transactions_limits() );
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_CASE( pending_transactions_fee_order_test )
+{ try {
+   ACTORS( (alice)(bob)(carol) );
+   fund( alice, asset(1000000) );
+   fund( bob, asset(1000000) );
+   fund( carol, asset(1000000) );
+   generate_block();
+
+   auto make_transfer = [this]( const account_id_type& from, const fc::ecc::private_key& key, int64_t extra_fee ) {
+      transfer_operation op;
+      op.from = from;
+      op.to = account_id_type();
+      op.amount = asset(1);
+      signed_transaction trx;
+      trx.operations.push_back( op );
+      set_expiration( db, trx );
+      db.current_fee_schedule().set_fee( trx.operations.back() );
+      trx.operations.back().get<transfer_operation>().fee.amount += extra_fee;
+      sign( trx, key );
+      return trx;
+   };
+
+   const signed_transaction alice_trx = make_transfer( alice_id, alice_private_key, 100 );
+   const signed_transaction bob_trx = make_transfer( bob_id, bob_private_key, 1000 );
+   const signed_transaction carol_trx = make_transfer( carol_id, carol_private_key, 100 );
+   PUSH_TX( db, alice_trx );
+   PUSH_TX( db, bob_trx );
+   PUSH_TX( db, carol_trx );
+
+   // only one of the transactions fits into a block
+   signed_block one;
+   one.transactions.emplace_back( bob_trx );
+   one.transactions.back().operation_results.emplace_back( void_result() );
+   db.modify( db.get_global_properties(), [&one]( global_property_object& gpo ) {
+      gpo.parameters.maximum_block_size = fc::raw::pack_size( one ) + 16;
+   });
+
+   // the highest fee per byte goes first, even though it arrived later
+   auto b = generate_block();
+   BOOST_REQUIRE_EQUAL( b.transactions.size(), 1u );
+   BOOST_CHECK( b.transactions.front().id() == bob_trx.id() );
+   BOOST_CHECK_EQUAL( db.get_pending_transactions_stats().last_block_postponed, 2u );
+
+   // same fee per byte, the arrival order is kept
+   b = generate_block();
+   BOOST_REQUIRE_EQUAL( b.transactions.size(), 1u );
+   BOOST_CHECK( b.transactions.front().id() == alice_trx.id() );
+   b = generate_block();
+   BOOST_REQUIRE_EQUAL( b.transactions.size(), 1u );
+   BOOST_CHECK( b.transactions.front().id() == carol_trx.id() );
+   BOOST_CHECK_EQUAL( db.get_pending_transactions_stats().count, 0u );
+} FC_LOG_AND_RETHROW() }
+
+namespace {
+   /// Makes every balance change slow, to exceed the block assembly time limit
+   struct slow_balance_index : public graphene::db::secondary_index
+   {
+      bool slow = false;
+      virtual void object_modified( const object& after ) override
+      {
+         if( slow )
+            std::this_thread::sleep_for( std::chrono::milliseconds(5) );
+      }
+   };
+}
+
+BOOST_AUTO_TEST_CASE( pending_transactions_assembly_time_test )
+{ try {
+   ACTORS( (alice)(bob)(carol) );
+   fund( alice, asset(1000000) );
+   fund( bob, asset(1000000) );
+   fund( carol, asset(1000000) );
+   generate_block();
+
+   auto* slow_index = db.add_secondary_index< primary_index<account_balance_index>, slow_balance_index >();
+
+   transfer( alice_id, committee_account, asset(1) );
+   transfer( bob_id, committee_account, asset(1) );
+   transfer( carol_id, committee_account, asset(1) );
+   BOOST_REQUIRE_EQUAL( db.get_pending_transactions_stats().count, 3u );
+
+   pending_transactions_limits limits;
+   limits.max_assembly_time_ms = 1;
+   db.set_pending_transactions_limits( limits );
+
+   // the first transaction takes longer than the limit, the others wait for the next block
+   slow_index->slow = true;
+   auto b = generate_block();
+   slow_index->slow = false;
+   BOOST_CHECK_EQUAL( b.transactions.size(), 1u );
+   BOOST_CHECK_EQUAL( db.get_pending_transactions_stats().last_block_included, 1u );
+   BOOST_CHECK_EQUAL( db.get_pending_transactions_stats().last_block_postponed, 2u );
+   BOOST_CHECK_EQUAL( db.get_pending_transactions_stats().count, 2u );
+
+   b = generate_block();
+   BOOST_CHECK_EQUAL( b.transactions.size(), 2u );
+   BOOST_CHECK_EQUAL( db.get_pending_transactions_stats().count, 0u );
+
+   db.set_pending_transactions_limits( pending_transactions_limits() );
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_CASE( account_name_hash_index_test )
+{ try {
+   const auto& ordered = db.get_index_type< account_index >().indices().get< by_name >();
+   const auto& hashed = db.get_index_type< account_index >().indices().get< by_name_hash >();
+   {
+      auto session = db._undo_db.start_undo_session();
+      ACTORS( (alice)(alicia) );
+      BOOST_CHECK( hashed.find( "alice" )->get_id() == alice_id );
+      BOOST_CHECK( hashed.find( "alicia" )->get_id() == alicia_id );
+      BOOST_CHECK( hashed.find( "alic" ) == hashed.end() );
+      BOOST_CHECK_EQUAL( ordered.size(), hashed.size() );
+   }
+   BOOST_CHECK( hashed.find( "alice" ) == hashed.end() );
+   BOOST_CHECK( ordered.find( "alice" ) == ordered.end() );
+   BOOST_CHECK_EQUAL( ordered.size(), hashed.size() );
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_CASE( balances_by_account_index_test )
+{ try {
+   ACTORS( (alice) );
+   const auto& bal_idx = db.get_index_type< primary_index< account_balance_index > >();
+   const auto& by_account = bal_idx.get_secondary_index< balances_by_account_index >();
+
+   const asset_id_type usd_id = create_user_issued_asset( "USDBIT", alice, 0 ).id;
+   const asset_id_type eur_id = create_user_issued_asset( "EURBIT", alice, 0 ).id;
+   const asset_id_type gbp_id = create_user_issued_asset( "GBPBIT", alice, 0 ).id;
+   issue_uia( alice_id, asset( 300, gbp_id ) );
+   issue_uia( alice_id, asset( 100, usd_id ) );
+   transfer( committee_account, alice_id, asset(1000) );
+   issue_uia( alice_id, asset( 200, eur_id ) );
+
+   // entries are kept sorted by asset whatever the insertion order
+   const vector< asset_id_type > expected = { asset_id_type(), usd_id, eur_id, gbp_id };
+   vector< asset_id_type > found;
+   for( const auto& entry : by_account.get_account_balances( alice_id ) )
+   {
+      BOOST_CHECK( entry.first == entry.second->asset_type );
+      found.push_back( entry.first );
+   }
+   BOOST_CHECK( found == expected );
+   BOOST_CHECK_EQUAL( by_account.get_account_balance( alice_id, eur_id )->balance.value, 200 );
+   BOOST_CHECK( by_account.get_account_balances( account_id_type(1000000) ).empty() );
+
+   // undo removes the entry again
+   {
+      auto session = db._undo_db.start_undo_session();
+      const asset_id_type jpy_id = create_user_issued_asset( "JPYBIT", alice, 0 ).id;
+      issue_uia( alice_id, asset( 5, jpy_id ) );
+      BOOST_CHECK_EQUAL( by_account.get_account_balances( alice_id ).size(), 5u );
+   }
+   BOOST_CHECK_EQUAL( by_account.get_account_balances( alice_id ).size(), 4u );
+   BOOST_CHECK( by_account.get_account_balance( alice_id, asset_id_type( gbp_id.instance.value + 1 ) ) == nullptr );
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_CASE( balances_to_maintain_index_test )
+{ try {
+   ACTORS( (alice) );
+   const auto& bal_idx = db.get_index_type< primary_index< account_balance_index > >();
+   const auto& to_maintain = bal_idx.get_secondary_index< balances_to_maintain_index >();
+
+   generate_blocks( db.get_dynamic_global_properties().next_maintenance_time );
+   BOOST_CHECK( to_maintain.get_flagged_balances().empty() );
+
+   transfer( committee_account, alice_id, asset(1000) );
+   const account_balance_object* alice_core = bal_idx.get_secondary_index< balances_by_account_index >()
+                                                     .get_account_balance( alice_id, asset_id_type() );
+   BOOST_REQUIRE( alice_core != nullptr );
+   vector< account_balance_id_type > flagged = to_maintain.get_flagged_balances();
+   BOOST_CHECK( std::find( flagged.begin(), flagged.end(), alice_core->get_id() ) != flagged.end() );
+
+   // maintenance copies the balances to the statistics and clears the flags
+   generate_blocks( db.get_dynamic_global_properties().next_maintenance_time );
+   BOOST_CHECK( to_maintain.get_flagged_balances().empty() );
+   BOOST_CHECK_EQUAL( alice_id(db).statistics(db).core_in_balance.value, 1000 );
+
+   // undo clears a flag again
+   {
+      auto session = db._undo_db.start_undo_session();
+      db.adjust_balance( alice_id, asset(1) );
+      flagged = to_maintain.get_flagged_balances();
+      BOOST_REQUIRE_EQUAL( flagged.size(), 1u );
+      BOOST_CHECK( flagged.front() == alice_core->get_id() );
+   }
+   BOOST_CHECK( to_maintain.get_flagged_balances().empty() );
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_CASE( chain_profiler_test )
+{ try {
+   ACTORS( (alice) );
+   BOOST_CHECK( db.get_profiler() == nullptr );
+
+   db.enable_profiling( true );
+   BOOST_REQUIRE( db.get_profiler() != nullptr );
+
+   transfer( committee_account, alice_id, asset(1000) );
+   generate_block();
+
+   chain_profile_report report = db.get_profiler()->get_report();
+   BOOST_CHECK_EQUAL( report.blocks, 1u );
+
+   auto transfers = std::find_if( report.operations.begin(), report.operations.end(),
+                                  []( const chain_profile_operation& o ) { return o.operation == "transfer_operation"; } );
+   BOOST_REQUIRE( transfers != report.operations.end() );
+   BOOST_CHECK_GE( transfers->count, 1u );
+   BOOST_CHECK_GE( transfers->total_us, transfers->apply_us );
+
+   auto trxs = std::find_if( report.stages.begin(), report.stages.end(),
+                             []( const chain_profile_counter& s ) { return s.name == "transactions"; } );
+   BOOST_REQUIRE( trxs != report.stages.end() );
+   BOOST_CHECK_EQUAL( trxs->count, 1u );
+
+   db.get_profiler()->reset();
+   report = db.get_profiler()->get_report();
+   BOOST_CHECK_EQUAL( report.blocks, 0u );
+   BOOST_CHECK( report.operations.empty() );
+   BOOST_CHECK( report.stages.empty() );
+
+   db.enable_profiling( false );
+   BOOST_CHECK( db.get_profiler() == nullptr );
+   generate_block();
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_CASE( lazy_impacted_accounts_test )
+{ try {
+   ACTORS( (alice) );
+   generate_block();
+
+   size_t notifications = 0;
+   flat_set<account_id_type> impacted;
+   boost::signals2::scoped_connection conn = db.observe_without_impacted_accounts( db.changed_objects, "test",
+      [&notifications,&impacted]( const vector<object_id_type>& ids, const flat_set<account_id_type>& accounts ) {
+         ++notifications;
+         impacted.insert( accounts.begin(), accounts.end() );
+      } );
+
+   transfer( committee_account, alice_id, asset(1000) );
+   generate_block();
+   BOOST_CHECK_GT( notifications, 0u );
+   BOOST_CHECK( impacted.empty() );
+
+   db.subscribe_to_impacted_accounts();
+   transfer( committee_account, alice_id, asset(1000) );
+   generate_block();
+   BOOST_CHECK( impacted.find( alice_id ) != impacted.end() );
+   db.unsubscribe_from_impacted_accounts();
+
+   // an observer connected with observe() gets the impacted accounts without subscribing
+   impacted.clear();
+   flat_set<account_id_type> other_impacted;
+   {
+      boost::signals2::scoped_connection other = db.observe( db.changed_objects, "other",
+         [&other_impacted]( const vector<object_id_type>& ids, const flat_set<account_id_type>& accounts ) {
+            other_impacted.insert( accounts.begin(), accounts.end() );
+         } );
+      transfer( committee_account, alice_id, asset(1000) );
+      generate_block();
+      BOOST_CHECK( other_impacted.find( alice_id ) != other_impacted.end() );
+   }
+
+   // and once it is gone they are skipped again
+   impacted.clear();
+   transfer( committee_account, alice_id, asset(1000) );
+   generate_block();
+   BOOST_CHECK( impacted.empty() );
+
+   // the observers without impacted accounts are no longer counted once disconnected
+   conn.disconnect();
+   other_impacted.clear();
+   boost::signals2::scoped_connection other = db.observe( db.changed_objects, "other",
+      [&other_impacted]( const vector<object_id_type>& ids, const flat_set<account_id_type>& accounts ) {
+         other_impacted.insert( accounts.begin(), accounts.end() );
+      } );
+   transfer( committee_account, alice_id, asset(1000) );
+   generate_block();
+   BOOST_CHECK( other_impacted.find( alice_id ) != other_impacted.end() );
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_CASE( dry_run_maintenance_test )
+{ try {
+   ACTORS( (alice) );
+   generate_block();
+
+   // a pending transaction survives the dry run
+   transfer( committee_account, alice_id, asset(1000) );
+   BOOST_REQUIRE_EQUAL( db.get_pending_transactions_stats().count, 1u );
+
+   const auto next_maintenance_time = db.get_dynamic_global_properties().next_maintenance_time;
+   const auto head_num = db.head_block_num();
+   const auto undo_size = db._undo_db.size();
+   const auto last_report = db.get_last_maintenance_report();
+   const auto maintenance_seed = db.get_maintenance_seed();
+
+   const maintenance_report report = db.dry_run_maintenance();
+   BOOST_CHECK_EQUAL( report.block_num, head_num + 1 );
+   BOOST_REQUIRE( !report.phases.empty() );
+   BOOST_CHECK_EQUAL( report.phases.front().name, "fba" );
+   BOOST_CHECK_EQUAL( report.phases.back().name, "budget" );
+   uint64_t modified = 0;
+   for( const auto& phase : report.phases )
+      modified += phase.objects_modified;
+   BOOST_CHECK_GT( modified, 0u );
+
+   // nothing was kept
+   BOOST_CHECK( db.get_dynamic_global_properties().next_maintenance_time == next_maintenance_time );
+   BOOST_CHECK_EQUAL( db.head_block_num(), head_num );
+   BOOST_CHECK_EQUAL( db._undo_db.size(), undo_size );
+   BOOST_CHECK_EQUAL( db.get_last_maintenance_report().block_num, last_report.block_num );
+   // commits and reveals are checked against the seed of the last real maintenance
+   BOOST_CHECK_EQUAL( db.get_maintenance_seed(), maintenance_seed );
+   BOOST_CHECK_EQUAL( db.get_pending_transactions_stats().count, 1u );
+   BOOST_CHECK_EQUAL( get_balance( alice_id, asset_id_type() ), 1000 );
+
+   // the real maintenance produces a report as well
+   generate_blocks( next_maintenance_time );
+   BOOST_CHECK_EQUAL( db.get_last_maintenance_report().phases.size(), report.phases.size() );
+} FC_LOG_AND_RETHROW() }
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -450,6 +450,11 @@ try {
       alice_htlc_id = alice_trx.operation_results[0].get<object_id_type>();
    }
 
+   const auto& algorithms = db.get_index_type< primary_index< htlc_index > >()
+                              .get_secondary_index< htlc_hash_algorithm_index >();
+   BOOST_REQUIRE( algorithms.get_algorithm( alice_htlc_id ).valid() );
+   BOOST_CHECK( algorithms.get_algorithm( alice_htlc_id )->is_type< htlc_algo_sha1 >() );
+
    // make sure Alice's money gets put on hold (100 - 20 - 4(fee) )
    BOOST_CHECK_EQUAL( get_balance( alice_id, graphene::chain::asset_id_type()), 76 * GRAPHENE_BLOCKCHAIN_PRECISION );
 
@@ -485,10 +490,17 @@ try {
       update_operation.fee = db.current_fee_schedule().calculate_fee( update_operation );
       trx.operations.push_back( update_operation );
       sign(trx, joker_private_key);
+      // precomputation hashes the preimage with the algorithm of the HTLC only
+      precomputable_transaction ptrx( trx );
+      db.precompute_parallel( ptrx ).wait();
+      const auto& precomputed = ptrx.operations[0].get< htlc_redeem_operation >().precomputed_hash;
+      BOOST_REQUIRE( precomputed );
+      BOOST_CHECK( precomputed->hash.is_type< htlc_algo_sha1 >() );
       PUSH_TX( db, trx, ~0 );
       generate_block();
       trx.clear();
    }
+   BOOST_CHECK( !algorithms.get_algorithm( alice_htlc_id ).valid() );
    // verify funds end up in Bob's account (100 + 20 )
    BOOST_CHECK_EQUAL( get_balance(bob_id,   graphene::chain::asset_id_type()), 120 * GRAPHENE_BLOCKCHAIN_PRECISION );
    // verify funds remain out of Alice's acount ( 100 - 20 - 4 )
@@ -1123,4 +1135,50 @@ try {
    }
 }
 
+BOOST_AUTO_TEST_CASE( htlc_precomputed_preimage_hash )
+{ try {
+   std::vector<char> pre_image(64);
+   generate_random_preimage( 64, pre_image );
+   std::vector<char> other_image( pre_image );
+   other_image[0] ^= 1;
+
+   const std::vector<htlc_hash> matching = { hash_it<fc::ripemd160>( pre_image ), hash_it<fc::sha1>( pre_image ),
+                                             hash_it<fc::sha256>( pre_image ), hash_it<fc::hash160>( pre_image ) };
+   const std::vector<htlc_hash> other = { hash_it<fc::ripemd160>( other_image ), hash_it<fc::sha1>( other_image ),
+                                          hash_it<fc::sha256>( other_image ), hash_it<fc::hash160>( other_image ) };
+
+   htlc_redeem_operation op;
+   op.preimage = pre_image;
+   BOOST_CHECK( !op.precomputed_hash );
+   for( const auto& h : matching )
+      BOOST_CHECK( op.preimage_matches( h ) );
+   for( const auto& h : other )
+      BOOST_CHECK( !op.preimage_matches( h ) );
+
+   // only the requested algorithm is hashed, the others are still checked correctly
+   op.precompute_preimage_hash( matching[2] );
+   BOOST_REQUIRE( op.precomputed_hash );
+   BOOST_CHECK( op.precomputed_hash->hash.get<fc::sha256>() == matching[2].get<fc::sha256>() );
+   for( const auto& h : matching )
+      BOOST_CHECK( op.preimage_matches( h ) );
+   for( const auto& h : other )
+      BOOST_CHECK( !op.preimage_matches( h ) );
+
+   // the cache travels with copies of the operation, but is ignored once the preimage changes
+   operation wrapped = op;
+   BOOST_CHECK( wrapped.get<htlc_redeem_operation>().precomputed_hash == op.precomputed_hash );
+   htlc_redeem_operation changed = op;
+   changed.preimage = other_image;
+   BOOST_CHECK( changed.preimage_matches( other[2] ) );
+   BOOST_CHECK( !changed.preimage_matches( matching[2] ) );
+   changed.precompute_preimage_hash( other[2] );
+   BOOST_CHECK( changed.precomputed_hash->hash.get<fc::sha256>() == other[2].get<fc::sha256>() );
+   BOOST_CHECK( op.precomputed_hash->hash.get<fc::sha256>() == matching[2].get<fc::sha256>() );
+
+   // and it is not serialized
+   htlc_redeem_operation unpacked = fc::raw::unpack<htlc_redeem_operation>( fc::raw::pack( op ) );
+   BOOST_CHECK( !unpacked.precomputed_hash );
+   BOOST_CHECK( unpacked.preimage_matches( matching[2] ) );
+} FC_LOG_AND_RETHROW() }
+
 BOOST_AUTO_TEST_SUITE_END()
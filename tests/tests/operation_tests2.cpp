@@ -1985,6 +1985,21 @@ BOOST_AUTO_TEST_CASE( top_n_special )
          BOOST_CHECK( stan_id(db).owner  == authority( 41376, bob_id, 32750,                  dan_id, 50000 ) );
          BOOST_CHECK( stan_id(db).active == authority( 57751, bob_id, 32750, chloe_id, 32750, dan_id, 50000 ) );
 
+         // nothing changed, Stan's account should not be touched by the next maintenance
+         bool stan_changed = false;
+         auto changed_connection = db.changed_objects.connect(
+            [&stan_changed,this]( const vector<object_id_type>& ids, const flat_set<account_id_type>& )
+            {
+               if( std::find( ids.begin(), ids.end(), object_id_type( stan_id ) ) != ids.end() )
+                  stan_changed = true;
+            } );
+         generate_blocks(db.get_dynamic_global_properties().next_maintenance_time);
+         changed_connection.disconnect();
+
+         BOOST_CHECK( !stan_changed );
+         BOOST_CHECK( stan_id(db).owner  == authority( 41376, bob_id, 32750,                  dan_id, 50000 ) );
+         BOOST_CHECK( stan_id(db).active == authority( 57751, bob_id, 32750, chloe_id, 32750, dan_id, 50000 ) );
+
          // TODO more rounding checks
       }
 
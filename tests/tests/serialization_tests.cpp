@@ -29,6 +29,7 @@
 
 #include <fc/crypto/digest.hpp>
 #include <fc/crypto/elliptic.hpp>
+#include <fc/io/json.hpp>
 #include <fc/reflect/variant.hpp>
 
 #include "../common/database_fixture.hpp"
@@ -112,4 +113,37 @@ BOOST_AUTO_TEST_CASE( extension_serialization_test )
    }
 }
 
+BOOST_AUTO_TEST_CASE( genesis_json_test )
+{
+   try
+   {
+      genesis_state_type genesis;
+      genesis.initial_timestamp = fc::time_point_sec( 1431700000 );
+      const auto key = public_key_type( fc::ecc::private_key::regenerate( fc::digest( 1 ) ).get_public_key() );
+      for( int i = 0; i < 20; ++i )
+      {
+         genesis.initial_accounts.emplace_back( "account" + fc::to_string(i), key, key, i % 2 == 0 );
+         genesis.initial_balances.push_back( { address(key), GRAPHENE_SYMBOL, i + 1 } );
+         genesis.ico_balances.push_back( { "eth\\\"" + fc::to_string(i), i } );
+      }
+      genesis.initial_witness_candidates.push_back( { "account0", key } );
+
+      const std::string json = fc::json::to_pretty_string( genesis );
+      const auto expected = fc::json::from_string( json ).as<genesis_state_type>( 20 );
+      const auto parsed = genesis_state_type::from_json( json, 20 );
+      BOOST_CHECK( fc::raw::pack( expected ) == fc::raw::pack( parsed ) );
+      BOOST_CHECK( fc::raw::pack( genesis ) == fc::raw::pack( parsed ) );
+
+      // unknown members are ignored like with the regular parser, malformed input is rejected
+      const std::string extended = "{\"unknown\":[1,{\"a\":\"]\"}]," + json.substr( json.find('{') + 1 );
+      BOOST_CHECK( fc::raw::pack( genesis ) == fc::raw::pack( genesis_state_type::from_json( extended, 20 ) ) );
+      BOOST_CHECK_THROW( genesis_state_type::from_json( json.substr( 0, json.size() / 2 ), 20 ), fc::exception );
+   }
+   catch ( const fc::exception& e )
+   {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
 BOOST_AUTO_TEST_SUITE_END()